@@ -27,7 +27,7 @@ public class LuGameplayFrame : ModuleRules
 		PublicDependencyModuleNames.AddRange(
 			new string[]
 			{
-				"Core", "CoreUObject", "Engine", "InputCore", "NetCore","UMG"
+				"Core", "CoreUObject", "Engine", "InputCore", "NetCore","UMG", "GameplayTags", "AIModule"
 				// ... add other public dependencies that you statically link with here ...
 			}
 		);
@@ -43,7 +43,9 @@ public class LuGameplayFrame : ModuleRules
 				"GameplayAbilities",
 				"GameplayTags",
 				"GameplayTasks",
-				"Paper2D"
+				"Paper2D",
+				"SignificanceManager",
+				"ReplicationGraph"
 				
 				// ... add private dependencies that you statically link with here ...	
 			}
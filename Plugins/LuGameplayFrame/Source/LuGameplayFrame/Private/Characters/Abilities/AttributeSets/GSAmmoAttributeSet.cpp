@@ -5,128 +5,270 @@
 #include "GameplayEffect.h"
 #include "GameplayEffectExtension.h"
 #include "Net/UnrealNetwork.h"
+#include "VTGameplayTags.h"
 
-UGSAmmoAttributeSet::UGSAmmoAttributeSet()
+namespace
 {
-	RifleAmmoTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rifle"));
-	RocketAmmoTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rocket"));
-	ShotgunAmmoTag = FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Shotgun"));
+	struct FGSAmmoTypes
+	{
+		TMap<FGameplayTag, int32> SlotsByTag;
+
+		// NumAmmoSlots rows, unused slots have no AmmoTag
+		TArray<FGSAmmoTypeRow> RowsBySlot;
+	};
+
+	FGSAmmoTypes& GetAmmoTypes()
+	{
+		static FGSAmmoTypes AmmoTypes;
+		return AmmoTypes;
+	}
+
+	struct FGSAmmoSlotAttributes
+	{
+		TArray<FGameplayAttribute> Reserve;
+		TArray<FGameplayAttribute> MaxReserve;
+
+		// Attribute -> slot, for the reserve and max attributes alike
+		TMap<FGameplayAttribute, int32> SlotsByAttribute;
+	};
+
+	// Found by name so the per slot properties only have to be declared
+	const FGSAmmoSlotAttributes& GetSlotAttributes()
+	{
+		static const FGSAmmoSlotAttributes SlotAttributes = []()
+		{
+			auto FindSlotAttribute = [](const TCHAR* Prefix, int32 Slot)
+			{
+				return FGameplayAttribute(FindFProperty<FProperty>(UGSAmmoAttributeSet::StaticClass(), *FString::Printf(TEXT("%s%d"), Prefix, Slot)));
+			};
+
+			FGSAmmoSlotAttributes Attributes;
+			for (int32 Slot = 0; Slot < UGSAmmoAttributeSet::NumAmmoSlots; ++Slot)
+			{
+				Attributes.Reserve.Add(FindSlotAttribute(TEXT("ReserveAmmo"), Slot));
+				Attributes.MaxReserve.Add(FindSlotAttribute(TEXT("MaxReserveAmmo"), Slot));
+				checkf(Attributes.Reserve.Last().IsValid() && Attributes.MaxReserve.Last().IsValid(), TEXT("UGSAmmoAttributeSet is missing ReserveAmmo%d or MaxReserveAmmo%d"), Slot, Slot);
+
+				Attributes.SlotsByAttribute.Add(Attributes.Reserve.Last(), Slot);
+				Attributes.SlotsByAttribute.Add(Attributes.MaxReserve.Last(), Slot);
+			}
+			checkf(!FindSlotAttribute(TEXT("ReserveAmmo"), UGSAmmoAttributeSet::NumAmmoSlots).IsValid(), TEXT("UGSAmmoAttributeSet declares more slots than NumAmmoSlots"));
+
+			return Attributes;
+		}();
+		return SlotAttributes;
+	}
 }
 
-void UGSAmmoAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue)
+UGSAmmoAttributeSet::UGSAmmoAttributeSet()
 {
-	Super::PreAttributeChange(Attribute, NewValue);
 }
 
-void UGSAmmoAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
+void UGSAmmoAttributeSet::PostInitProperties()
 {
-	Super::PostGameplayEffectExecute(Data);
+	Super::PostInitProperties();
 
-	if (Data.EvaluatedData.Attribute == GetRifleReserveAmmoAttribute())
+	// After the archetype's values have been copied in, so a Blueprint or subobject template can't undo the table.
+	// Templates keep their own values, every instance gets the table.
+	if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
 	{
-		float Ammo = GetRifleReserveAmmo();
-		SetRifleReserveAmmo(FMath::Clamp<float>(Ammo, 0, GetMaxRifleReserveAmmo()));
+		return;
 	}
-	else if (Data.EvaluatedData.Attribute == GetRocketReserveAmmoAttribute())
+
+	const TArray<FGSAmmoTypeRow>& Rows = GetAmmoTypes().RowsBySlot;
+	for (int32 Slot = 0; Slot < Rows.Num(); ++Slot)
 	{
-		float Ammo = GetRocketReserveAmmo();
-		SetRocketReserveAmmo(FMath::Clamp<float>(Ammo, 0, GetMaxRocketReserveAmmo()));
+		if (!Rows[Slot].AmmoTag.IsValid())
+		{
+			continue;
+		}
+
+		GetMaxReserveAmmoData(Slot)->SetBaseValue(Rows[Slot].MaxReserveAmmo);
+		GetMaxReserveAmmoData(Slot)->SetCurrentValue(Rows[Slot].MaxReserveAmmo);
+		GetReserveAmmoData(Slot)->SetBaseValue(Rows[Slot].StartingReserveAmmo);
+		GetReserveAmmoData(Slot)->SetCurrentValue(Rows[Slot].StartingReserveAmmo);
 	}
-	else if (Data.EvaluatedData.Attribute == GetShotgunReserveAmmoAttribute())
+}
+
+void UGSAmmoAttributeSet::InitAmmoTypes(const UDataTable* AmmoTypeTable)
+{
+	FGSAmmoTypes& AmmoTypes = GetAmmoTypes();
+	AmmoTypes.SlotsByTag.Reset();
+	AmmoTypes.RowsBySlot.Reset();
+	AmmoTypes.RowsBySlot.SetNum(NumAmmoSlots);
+
+	if (AmmoTypeTable)
+	{
+		AmmoTypeTable->ForeachRow<FGSAmmoTypeRow>(TEXT("InitAmmoTypes"), [&AmmoTypes, AmmoTypeTable](const FName& RowName, const FGSAmmoTypeRow& Row)
+		{
+			if (!ensureMsgf(Row.Slot >= 0 && Row.Slot < NumAmmoSlots, TEXT("%s row %s has Slot %d, ammo slots are 0 to %d"), *AmmoTypeTable->GetName(), *RowName.ToString(), Row.Slot, NumAmmoSlots - 1))
+			{
+				return;
+			}
+
+			if (AmmoTypes.RowsBySlot[Row.Slot].AmmoTag.IsValid())
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s() %s row %s uses slot %d, which %s already has"), *FString(__FUNCTION__), *AmmoTypeTable->GetName(), *RowName.ToString(), Row.Slot, *AmmoTypes.RowsBySlot[Row.Slot].AmmoTag.ToString());
+				return;
+			}
+
+			if (!Row.AmmoTag.IsValid() || AmmoTypes.SlotsByTag.Contains(Row.AmmoTag))
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s() %s row %s has a missing or duplicate AmmoTag"), *FString(__FUNCTION__), *AmmoTypeTable->GetName(), *RowName.ToString());
+				return;
+			}
+
+			AmmoTypes.RowsBySlot[Row.Slot] = Row;
+			AmmoTypes.SlotsByTag.Add(Row.AmmoTag, Row.Slot);
+		});
+	}
+	else
 	{
-		float Ammo = GetShotgunReserveAmmo();
-		SetShotgunReserveAmmo(FMath::Clamp<float>(Ammo, 0, GetMaxShotgunReserveAmmo()));
+		// No table configured. Max values then come from the DefaultAttributes effect.
+		const FGameplayTag DefaultAmmoTags[] = { VTGameplayTags::Weapon_Ammo_Rifle, VTGameplayTags::Weapon_Ammo_Rocket, VTGameplayTags::Weapon_Ammo_Shotgun };
+		for (int32 Slot = 0; Slot < UE_ARRAY_COUNT(DefaultAmmoTags); ++Slot)
+		{
+			AmmoTypes.RowsBySlot[Slot].AmmoTag = DefaultAmmoTags[Slot];
+			AmmoTypes.RowsBySlot[Slot].Slot = Slot;
+			AmmoTypes.SlotsByTag.Add(DefaultAmmoTags[Slot], Slot);
+		}
 	}
 }
 
-void UGSAmmoAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+int32 UGSAmmoAttributeSet::GetAmmoSlotForTag(const FGameplayTag& AmmoTag)
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	const int32* Slot = GetAmmoTypes().SlotsByTag.Find(AmmoTag);
+	return Slot ? *Slot : INDEX_NONE;
+}
 
-	DOREPLIFETIME_CONDITION_NOTIFY(UGSAmmoAttributeSet, RifleReserveAmmo, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UGSAmmoAttributeSet, MaxRifleReserveAmmo, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UGSAmmoAttributeSet, RocketReserveAmmo, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UGSAmmoAttributeSet, MaxRocketReserveAmmo, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UGSAmmoAttributeSet, ShotgunReserveAmmo, COND_None, REPNOTIFY_Always);
-	DOREPLIFETIME_CONDITION_NOTIFY(UGSAmmoAttributeSet, MaxShotgunReserveAmmo, COND_None, REPNOTIFY_Always);
+FGameplayAttribute UGSAmmoAttributeSet::GetReserveAmmoAttributeForSlot(int32 Slot)
+{
+	return GetSlotAttributes().Reserve.IsValidIndex(Slot) ? GetSlotAttributes().Reserve[Slot] : FGameplayAttribute();
 }
 
-FGameplayAttribute UGSAmmoAttributeSet::GetReserveAmmoAttributeFromTag(FGameplayTag& PrimaryAmmoTag)
+FGameplayAttribute UGSAmmoAttributeSet::GetMaxReserveAmmoAttributeForSlot(int32 Slot)
 {
-	if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rifle")))
-	{
-		return GetRifleReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rocket")))
-	{
-		return GetRocketReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Shotgun")))
-	{
-		return GetShotgunReserveAmmoAttribute();
-	}
+	return GetSlotAttributes().MaxReserve.IsValidIndex(Slot) ? GetSlotAttributes().MaxReserve[Slot] : FGameplayAttribute();
+}
 
-	return FGameplayAttribute();
+FGameplayAttribute UGSAmmoAttributeSet::GetReserveAmmoAttributeFromTag(FGameplayTag& PrimaryAmmoTag)
+{
+	return GetReserveAmmoAttributeForSlot(GetAmmoSlotForTag(PrimaryAmmoTag));
 }
 
 FGameplayAttribute UGSAmmoAttributeSet::GetMaxReserveAmmoAttributeFromTag(FGameplayTag& PrimaryAmmoTag)
 {
-	if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rifle")))
-	{
-		return GetMaxRifleReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Rocket")))
-	{
-		return GetMaxRocketReserveAmmoAttribute();
-	}
-	else if (PrimaryAmmoTag == FGameplayTag::RequestGameplayTag(FName("Weapon.Ammo.Shotgun")))
-	{
-		return GetMaxShotgunReserveAmmoAttribute();
-	}
+	return GetMaxReserveAmmoAttributeForSlot(GetAmmoSlotForTag(PrimaryAmmoTag));
+}
 
-	return FGameplayAttribute();
+float UGSAmmoAttributeSet::GetReserveAmmoForTag(FGameplayTag AmmoTag) const
+{
+	const FGameplayAttributeData* Data = GetReserveAmmoData(GetAmmoSlotForTag(AmmoTag));
+	return Data ? Data->GetCurrentValue() : 0.0f;
 }
 
-void UGSAmmoAttributeSet::AdjustAttributeForMaxChange(FGameplayAttributeData& AffectedAttribute, const FGameplayAttributeData& MaxAttribute, float NewMaxValue, const FGameplayAttribute& AffectedAttributeProperty)
+float UGSAmmoAttributeSet::GetMaxReserveAmmoForTag(FGameplayTag AmmoTag) const
 {
-	UAbilitySystemComponent* AbilityComp = GetOwningAbilitySystemComponent();
-	const float CurrentMaxValue = MaxAttribute.GetCurrentValue();
-	if (!FMath::IsNearlyEqual(CurrentMaxValue, NewMaxValue) && AbilityComp)
-	{
-		// Change current value to maintain the current Val / Max percent
-		const float CurrentValue = AffectedAttribute.GetCurrentValue();
-		float NewDelta = (CurrentMaxValue > 0.f) ? (CurrentValue * NewMaxValue / CurrentMaxValue) - CurrentValue : NewMaxValue;
+	const FGameplayAttributeData* Data = GetMaxReserveAmmoData(GetAmmoSlotForTag(AmmoTag));
+	return Data ? Data->GetCurrentValue() : 0.0f;
+}
 
-		AbilityComp->ApplyModToAttributeUnsafe(AffectedAttributeProperty, EGameplayModOp::Additive, NewDelta);
-	}
+FGameplayAttributeData* UGSAmmoAttributeSet::GetReserveAmmoData(int32 Slot)
+{
+	return GetSlotAttributes().Reserve.IsValidIndex(Slot) ? GetSlotAttributes().Reserve[Slot].GetGameplayAttributeData(this) : nullptr;
 }
 
-void UGSAmmoAttributeSet::OnRep_RifleReserveAmmo(const FGameplayAttributeData& OldRifleReserveAmmo)
+FGameplayAttributeData* UGSAmmoAttributeSet::GetMaxReserveAmmoData(int32 Slot)
 {
-	GAMEPLAYATTRIBUTE_REPNOTIFY(UGSAmmoAttributeSet, RifleReserveAmmo, OldRifleReserveAmmo);
+	return GetSlotAttributes().MaxReserve.IsValidIndex(Slot) ? GetSlotAttributes().MaxReserve[Slot].GetGameplayAttributeData(this) : nullptr;
 }
 
-void UGSAmmoAttributeSet::OnRep_MaxRifleReserveAmmo(const FGameplayAttributeData& OldMaxRifleReserveAmmo)
+const FGameplayAttributeData* UGSAmmoAttributeSet::GetReserveAmmoData(int32 Slot) const
 {
-	GAMEPLAYATTRIBUTE_REPNOTIFY(UGSAmmoAttributeSet, MaxRifleReserveAmmo, OldMaxRifleReserveAmmo);
+	return const_cast<UGSAmmoAttributeSet*>(this)->GetReserveAmmoData(Slot);
 }
 
-void UGSAmmoAttributeSet::OnRep_RocketReserveAmmo(const FGameplayAttributeData& OldRocketReserveAmmo)
+const FGameplayAttributeData* UGSAmmoAttributeSet::GetMaxReserveAmmoData(int32 Slot) const
 {
-	GAMEPLAYATTRIBUTE_REPNOTIFY(UGSAmmoAttributeSet, RocketReserveAmmo, OldRocketReserveAmmo);
+	return const_cast<UGSAmmoAttributeSet*>(this)->GetMaxReserveAmmoData(Slot);
 }
 
-void UGSAmmoAttributeSet::OnRep_MaxRocketReserveAmmo(const FGameplayAttributeData& OldMaxRocketReserveAmmo)
+void UGSAmmoAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
 {
-	GAMEPLAYATTRIBUTE_REPNOTIFY(UGSAmmoAttributeSet, MaxRocketReserveAmmo, OldMaxRocketReserveAmmo);
+	Super::PostGameplayEffectExecute(Data);
+
+	const int32* Slot = GetSlotAttributes().SlotsByAttribute.Find(Data.EvaluatedData.Attribute);
+	if (!Slot)
+	{
+		return;
+	}
+
+	// Reserve or its max changed, either way the reserve has to fit under the max
+	const FGameplayAttribute ReserveAttribute = GetSlotAttributes().Reserve[*Slot];
+	const float Ammo = GetReserveAmmoData(*Slot)->GetCurrentValue();
+	const float MaxAmmo = GetMaxReserveAmmoData(*Slot)->GetCurrentValue();
+	const float ClampedAmmo = FMath::Clamp<float>(Ammo, 0, MaxAmmo);
+	if (ClampedAmmo != Ammo)
+	{
+		GetOwningAbilitySystemComponentChecked()->SetNumericAttributeBase(ReserveAttribute, ClampedAmmo);
+	}
+}
+
+void UGSAmmoAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams Params;
+	Params.RepNotifyCondition = REPNOTIFY_Always;
+	for (int32 Slot = 0; Slot < NumAmmoSlots; ++Slot)
+	{
+		RegisterReplicatedLifetimeProperty(GetSlotAttributes().Reserve[Slot].GetUProperty(), OutLifetimeProps, Params);
+		RegisterReplicatedLifetimeProperty(GetSlotAttributes().MaxReserve[Slot].GetUProperty(), OutLifetimeProps, Params);
+	}
 }
 
-void UGSAmmoAttributeSet::OnRep_ShotgunReserveAmmo(const FGameplayAttributeData& OldShotgunReserveAmmo)
+void UGSAmmoAttributeSet::RefillReserveAmmo()
 {
-	GAMEPLAYATTRIBUTE_REPNOTIFY(UGSAmmoAttributeSet, ShotgunReserveAmmo, OldShotgunReserveAmmo);
+	UAbilitySystemComponent* AbilityComp = GetOwningAbilitySystemComponent();
+	if (!AbilityComp)
+	{
+		return;
+	}
+
+	const TArray<FGSAmmoTypeRow>& Rows = GetAmmoTypes().RowsBySlot;
+	for (int32 Slot = 0; Slot < Rows.Num(); ++Slot)
+	{
+		if (!Rows[Slot].AmmoTag.IsValid())
+		{
+			continue;
+		}
+
+		AbilityComp->SetNumericAttributeBase(GetSlotAttributes().Reserve[Slot], GetMaxReserveAmmoData(Slot)->GetCurrentValue());
+	}
 }
 
-void UGSAmmoAttributeSet::OnRep_MaxShotgunReserveAmmo(const FGameplayAttributeData& OldMaxShotgunReserveAmmo)
+void UGSAmmoAttributeSet::OnRepAmmoSlot(const FGameplayAttribute& Attribute, const FGameplayAttributeData& OldValue)
 {
-	GAMEPLAYATTRIBUTE_REPNOTIFY(UGSAmmoAttributeSet, MaxShotgunReserveAmmo, OldMaxShotgunReserveAmmo);
+	// What GAMEPLAYATTRIBUTE_REPNOTIFY does, for an attribute picked at runtime
+	GetOwningAbilitySystemComponentChecked()->SetBaseAttributeValueFromReplication(Attribute, *Attribute.GetGameplayAttributeData(this), OldValue);
 }
+
+// One line per slot, see NumAmmoSlots
+#define GS_AMMO_SLOT(Slot) \
+	void UGSAmmoAttributeSet::OnRep_ReserveAmmo##Slot(const FGameplayAttributeData& OldValue) { OnRepAmmoSlot(GetSlotAttributes().Reserve[Slot], OldValue); } \
+	void UGSAmmoAttributeSet::OnRep_MaxReserveAmmo##Slot(const FGameplayAttributeData& OldValue) { OnRepAmmoSlot(GetSlotAttributes().MaxReserve[Slot], OldValue); }
+
+GS_AMMO_SLOT(0)
+GS_AMMO_SLOT(1)
+GS_AMMO_SLOT(2)
+GS_AMMO_SLOT(3)
+GS_AMMO_SLOT(4)
+GS_AMMO_SLOT(5)
+GS_AMMO_SLOT(6)
+GS_AMMO_SLOT(7)
+GS_AMMO_SLOT(8)
+GS_AMMO_SLOT(9)
+GS_AMMO_SLOT(10)
+GS_AMMO_SLOT(11)
+
+#undef GS_AMMO_SLOT
@@ -2,16 +2,18 @@
 
 
 #include "Characters/Abilities/AttributeSets/GSAttributeSetBase.h"
+#include "Characters/GSCharacterMovementComponent.h"
 #include "Characters/VTCharacterBase.h"
 #include "GameplayEffect.h"
 #include "GameplayEffectExtension.h"
 #include "Net/UnrealNetwork.h"
-#include "Player/GSPlayerController.h"
+#include "Player/VTDamageNumberBatchComponent.h"
+#include "VTGameplayTags.h"
 
 UGSAttributeSetBase::UGSAttributeSetBase()
 {
 	// Cache tags
-	HeadShotTag = FGameplayTag::RequestGameplayTag(FName("Effect.Damage.HeadShot"));
+	HeadShotTag = VTGameplayTags::Effect_Damage_HeadShot;
 }
 
 void UGSAttributeSetBase::PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue)
@@ -39,6 +41,27 @@ void UGSAttributeSetBase::PreAttributeChange(const FGameplayAttribute& Attribute
 	}
 }
 
+bool UGSAttributeSetBase::PreGameplayEffectExecute(FGameplayEffectModCallbackData& Data)
+{
+	if (!Super::PreGameplayEffectExecute(Data))
+	{
+		return false;
+	}
+
+	// Stamina regen is simulated by the movement component. A periodic regen GE left in the assets would regen twice.
+	if (Data.EvaluatedData.Attribute == GetStaminaAttribute() && Data.EvaluatedData.Magnitude > 0.0f && Data.EffectSpec.GetPeriod() > 0.0f)
+	{
+		const AVTCharacterBase* TargetCharacter = Data.Target.AbilityActorInfo.IsValid() ? Cast<AVTCharacterBase>(Data.Target.AbilityActorInfo->AvatarActor.Get()) : nullptr;
+		const UGSCharacterMovementComponent* GSMovement = TargetCharacter ? Cast<UGSCharacterMovementComponent>(TargetCharacter->GetCharacterMovement()) : nullptr;
+		if (GSMovement && GSMovement->IsSimulatingStamina())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void UGSAttributeSetBase::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
 {
 	Super::PostGameplayEffectExecute(Data);
@@ -139,18 +162,15 @@ void UGSAttributeSetBase::PostGameplayEffectExecute(const FGameplayEffectModCall
 				// Show damage number for the Source player unless it was self damage
 				if (SourceActor != TargetActor)
 				{
-					AGSPlayerController* PC = Cast<AGSPlayerController>(SourceController);
-					if (PC)
-					{
-						FGameplayTagContainer DamageNumberTags;
+					FGameplayTagContainer DamageNumberTags;
 
-						if (Data.EffectSpec.GetDynamicAssetTags().HasTag(HeadShotTag))
-						{
-							DamageNumberTags.AddTagFast(HeadShotTag);
-						}
-
-						PC->ShowDamageNumber(LocalDamageDone, TargetCharacter, DamageNumberTags);
+					if (Data.EffectSpec.GetDynamicAssetTags().HasTag(HeadShotTag))
+					{
+						DamageNumberTags.AddTagFast(HeadShotTag);
 					}
+
+					// Batched and sent to the source player's client once per frame
+					UVTDamageNumberBatchComponent::QueueDamageNumber(SourceController, LocalDamageDone, TargetCharacter, DamageNumberTags);
 				}
 
 				if (!TargetCharacter->IsAlive())
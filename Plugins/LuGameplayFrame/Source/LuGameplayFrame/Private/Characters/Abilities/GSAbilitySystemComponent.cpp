@@ -7,11 +7,40 @@
 #include "AbilitySystemLog.h"
 #include "Animation/AnimInstance.h"
 #include "Characters/Abilities/GSGameplayAbility.h"
+#include "Characters/GSCharacterMovementComponent.h"
+#include "Characters/VTCharacterBase.h"
 #include "GameplayCueManager.h"
 #include "GSBlueprintFunctionLibrary.h"
+#include "LuGameplayFrame.h"
 #include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+#include "VTGameplayTags.h"
 #include "Weapons/GSWeapon.h"
 
+DECLARE_CYCLE_STAT(TEXT("Handle Gameplay Event"), STAT_GSHandleGameplayEvent, STATGROUP_LuGameplayFrame);
+DECLARE_CYCLE_STAT(TEXT("Rebuild Ability Index"), STAT_GSRebuildAbilityIndex, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Events"), STAT_GSGameplayEvents, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ability RPC Batches Sent"), STAT_GSAbilityRPCBatchesSent, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ability RPC Batches Merged"), STAT_GSAbilityRPCBatchesMerged, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<bool> CVarAbilityInputInMoves(
+	TEXT("VT.AbilityInput.ReplicateInMoves"),
+	false,
+	TEXT("Send ability input edges in character moves instead of one reliable RPC per press and release")
+);
+
+static TAutoConsoleVariable<int32> CVarAbilityRPCMaxBatchesPerRPC(
+	TEXT("VT.AbilityRPC.MaxBatchesPerRPC"),
+	UGSAbilitySystemComponent::MaxAbilityRPCBatchesPerRPC,
+	TEXT("Most ability batches one ServerAbilityRPCMultiBatch carries. Clamped to MaxAbilityRPCBatchesPerRPC, which the server enforces.")
+);
+
+static TAutoConsoleVariable<int32> CVarAbilityRPCLogStats(
+	TEXT("VT.AbilityRPC.LogStats"),
+	0,
+	TEXT("Log ability batch RPCs per second and the batches they carried, i.e. the RPCs sent without merging")
+);
+
 static TAutoConsoleVariable<float> CVarReplayMontageErrorThreshold(
 	TEXT("GS.replay.MontageErrorThreshold"),
 	0.5f,
@@ -26,7 +55,26 @@ void UGSAbilitySystemComponent::GetLifetimeReplicatedProps(TArray<FLifetimePrope
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UGSAbilitySystemComponent, RepAnimMontageInfoForMeshes);
+	DOREPLIFETIME_CONDITION(UGSAbilitySystemComponent, RepAnimMontageInfoForMeshes, COND_Custom);
+}
+
+void UGSAbilitySystemComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UGSAbilitySystemComponent, RepAnimMontageInfoForMeshes, !ReplicatesMontagesThroughAvatar());
+}
+
+bool UGSAbilitySystemComponent::ReplicatesMontagesThroughAvatar() const
+{
+	const AActor* Avatar = GetAvatarActor_Direct();
+	return Avatar && Avatar != GetOwner() && Avatar->IsA<AVTCharacterBase>();
+}
+
+void UGSAbilitySystemComponent::SetRepAnimMontageInfoFromAvatar(const TArray<FGameplayAbilityRepAnimMontageForMesh>& InRepAnimMontageInfo)
+{
+	RepAnimMontageInfoForMeshes = InRepAnimMontageInfo;
+	OnRep_ReplicatedAnimMontageForMesh();
 }
 
 bool UGSAbilitySystemComponent::GetShouldTick() const
@@ -65,10 +113,267 @@ void UGSAbilitySystemComponent::InitAbilityActorInfo(AActor* InOwnerActor, AActo
 	LocalAnimMontageInfoForMeshes = TArray<FGameplayAbilityLocalAnimMontageForMesh>();
 	RepAnimMontageInfoForMeshes = TArray<FGameplayAbilityRepAnimMontageForMesh>();
 
+	// The avatar may have received montage info before we knew it was ours
+	const AVTCharacterBase* AvatarCharacter = Cast<AVTCharacterBase>(InAvatarActor);
+	if (AvatarCharacter && !IsOwnerActorAuthoritative() && ReplicatesMontagesThroughAvatar() && AvatarCharacter->GetAbilityMontageInfoForMeshes().Num() > 0)
+	{
+		RepAnimMontageInfoForMeshes = AvatarCharacter->GetAbilityMontageInfoForMeshes();
+		bPendingMontageRep = true;
+	}
+
 	if (bPendingMontageRep)
 	{
 		OnRep_ReplicatedAnimMontageForMesh();
 	}
+
+	// Also fires on clients for replicated effects, so the cooldown cache works everywhere
+	if (!CooldownEffectAddedHandle.IsValid())
+	{
+		CooldownEffectAddedHandle = OnActiveGameplayEffectAddedDelegateToSelf.AddUObject(this, &UGSAbilitySystemComponent::OnCooldownEffectAdded);
+		CooldownEffectRemovedHandle = OnAnyGameplayEffectRemovedDelegate().AddUObject(this, &UGSAbilitySystemComponent::OnCooldownEffectRemoved);
+	}
+
+	if (!InteractingTagHandle.IsValid())
+	{
+		InteractingTagHandle = RegisterGameplayTagEvent(VTGameplayTags::State_Interacting, EGameplayTagEventType::AnyCountChange).AddUObject(this, &UGSAbilitySystemComponent::OnInteractingTagChanged);
+		InteractingRemovalTagHandle = RegisterGameplayTagEvent(VTGameplayTags::State_InteractingRemoval, EGameplayTagEventType::AnyCountChange).AddUObject(this, &UGSAbilitySystemComponent::OnInteractingTagChanged);
+		OnInteractingTagChanged(FGameplayTag(), 0);
+	}
+}
+
+bool UGSAbilitySystemComponent::TryActivateAbilitiesByTagIndexed(const FGameplayTagContainer& GameplayTagContainer, bool bAllowRemoteActivation)
+{
+	// Copied because activation can grant or clear abilities
+	TArray<FGameplayAbilitySpecHandle> HandlesToActivate;
+	GetAbilitySpecHandlesByAllMatchingTags(GameplayTagContainer, HandlesToActivate);
+
+	bool bSuccess = false;
+	for (const FGameplayAbilitySpecHandle& Handle : HandlesToActivate)
+	{
+		bSuccess |= TryActivateAbility(Handle, bAllowRemoteActivation);
+	}
+
+	return bSuccess;
+}
+
+void UGSAbilitySystemComponent::GetAbilitySpecHandlesByAllMatchingTags(const FGameplayTagContainer& GameplayTagContainer, TArray<FGameplayAbilitySpecHandle>& OutHandles)
+{
+	if (GameplayTagContainer.IsEmpty())
+	{
+		return;
+	}
+
+	RebuildAbilityIndex();
+
+	// Start from the smallest candidate list, then check the rest of the container on those specs only
+	const TArray<FGameplayAbilitySpecHandle>* Candidates = nullptr;
+	for (const FGameplayTag& Tag : GameplayTagContainer)
+	{
+		const TArray<FGameplayAbilitySpecHandle>* Handles = SpecHandlesByAbilityTag.Find(Tag);
+		if (!Handles)
+		{
+			return;
+		}
+
+		if (!Candidates || Handles->Num() < Candidates->Num())
+		{
+			Candidates = Handles;
+		}
+	}
+
+	const bool bSingleTag = GameplayTagContainer.Num() == 1;
+	for (const FGameplayAbilitySpecHandle& Handle : *Candidates)
+	{
+		const FGameplayAbilitySpec* Spec = FindAbilitySpecFromHandleIndexed(Handle);
+		if (Spec && Spec->Ability && (bSingleTag || Spec->Ability->AbilityTags.HasAll(GameplayTagContainer)))
+		{
+			OutHandles.Add(Handle);
+		}
+	}
+}
+
+FGameplayAbilitySpec* UGSAbilitySystemComponent::FindAbilitySpecFromHandleIndexed(FGameplayAbilitySpecHandle Handle)
+{
+	RebuildAbilityIndex();
+
+	const int32* Index = SpecIndexByHandle.Find(Handle);
+	if (Index && ActivatableAbilities.Items.IsValidIndex(*Index) && ActivatableAbilities.Items[*Index].Handle == Handle)
+	{
+		return &ActivatableAbilities.Items[*Index];
+	}
+
+	// The list changed without OnGiveAbility or OnRemoveAbility, e.g. a replicated removal shifted the items
+	if (Index)
+	{
+		bAbilityIndexDirty = true;
+		return FindAbilitySpecFromHandle(Handle);
+	}
+
+	return nullptr;
+}
+
+int32 UGSAbilitySystemComponent::HandleGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GSHandleGameplayEvent);
+	INC_DWORD_STAT(STAT_GSGameplayEvents);
+
+	// Event triggered activations call ServerTryActivateAbilityWithEventData directly, after the batches made before them
+	if (!IsOwnerActorAuthoritative())
+	{
+		FlushPendingAbilityRPCBatches();
+	}
+
+	int32 TriggeredCount = 0;
+
+	{
+		ABILITYLIST_SCOPE_LOCK();
+
+		// Holding a reference keeps the list alive if a triggered ability resets the cache or sends another event
+		const TSharedRef<const TArray<FGameplayAbilitySpecHandle>> TriggeredHandles = GetTriggeredHandlesForEvent(EventTag);
+		for (const FGameplayAbilitySpecHandle& AbilityHandle : *TriggeredHandles)
+		{
+			if (TriggerAbilityFromGameplayEvent(AbilityHandle, AbilityActorInfo.Get(), EventTag, Payload, *this))
+			{
+				TriggeredCount++;
+			}
+		}
+	}
+
+	// Same delegate handling as the engine version
+	if (FGameplayEventMulticastDelegate* Delegate = GenericGameplayEventCallbacks.Find(EventTag))
+	{
+		FGameplayEventMulticastDelegate DelegateCopy = *Delegate;
+		DelegateCopy.Broadcast(Payload);
+	}
+
+	if (GameplayEventTagContainerDelegates.Num() > 0)
+	{
+		TArray<TPair<FGameplayTagContainer, FGameplayEventTagMulticastDelegate>> LocalGameplayEventTagContainerDelegates = GameplayEventTagContainerDelegates;
+		for (TPair<FGameplayTagContainer, FGameplayEventTagMulticastDelegate>& SearchPair : LocalGameplayEventTagContainerDelegates)
+		{
+			if (SearchPair.Key.IsEmpty() || EventTag.MatchesAny(SearchPair.Key))
+			{
+				SearchPair.Value.Broadcast(EventTag, Payload);
+			}
+		}
+	}
+
+	return TriggeredCount;
+}
+
+void UGSAbilitySystemComponent::OnGiveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnGiveAbility(AbilitySpec);
+
+	bAbilityIndexDirty = true;
+	TriggeredHandlesByEventTag.Reset();
+}
+
+void UGSAbilitySystemComponent::OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec)
+{
+	Super::OnRemoveAbility(AbilitySpec);
+
+	// The spec is still in the list here, so only mark. The next lookup rebuilds without it.
+	bAbilityIndexDirty = true;
+	TriggeredHandlesByEventTag.Reset();
+}
+
+void UGSAbilitySystemComponent::RebuildAbilityIndex()
+{
+	if (!bAbilityIndexDirty)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GSRebuildAbilityIndex);
+
+	SpecIndexByHandle.Reset();
+	SpecHandlesByAbilityTag.Reset();
+
+	for (int32 Index = 0; Index < ActivatableAbilities.Items.Num(); ++Index)
+	{
+		const FGameplayAbilitySpec& Spec = ActivatableAbilities.Items[Index];
+		SpecIndexByHandle.Add(Spec.Handle, Index);
+
+		if (!Spec.Ability)
+		{
+			continue;
+		}
+
+		for (const FGameplayTag& Tag : Spec.Ability->AbilityTags.GetGameplayTagParents())
+		{
+			SpecHandlesByAbilityTag.FindOrAdd(Tag).Add(Spec.Handle);
+		}
+	}
+
+	bAbilityIndexDirty = false;
+}
+
+TSharedRef<const TArray<FGameplayAbilitySpecHandle>> UGSAbilitySystemComponent::GetTriggeredHandlesForEvent(const FGameplayTag& EventTag)
+{
+	if (const TSharedRef<const TArray<FGameplayAbilitySpecHandle>>* Cached = TriggeredHandlesByEventTag.Find(EventTag))
+	{
+		return *Cached;
+	}
+
+	// Same matching as the engine's parent walk, done once per event tag
+	TSharedRef<TArray<FGameplayAbilitySpecHandle>> Handles = MakeShared<TArray<FGameplayAbilitySpecHandle>>();
+	for (FGameplayTag CurrentTag = EventTag; CurrentTag.IsValid(); CurrentTag = CurrentTag.RequestDirectParent())
+	{
+		if (const TArray<FGameplayAbilitySpecHandle>* TriggeredAbilityHandles = GameplayEventTriggeredAbilities.Find(CurrentTag))
+		{
+			Handles->Append(*TriggeredAbilityHandles);
+		}
+	}
+
+	TriggeredHandlesByEventTag.Add(EventTag, Handles);
+	return Handles;
+}
+
+void UGSAbilitySystemComponent::SetCurrentWeaponSource(UObject* NewWeaponSource)
+{
+	CurrentWeaponSource = NewWeaponSource;
+	bHasCurrentWeaponSource = true;
+}
+
+void UGSAbilitySystemComponent::OnInteractingTagChanged(const FGameplayTag Tag, int32 NewCount)
+{
+	bIsInteracting = GetTagCount(VTGameplayTags::State_Interacting) > GetTagCount(VTGameplayTags::State_InteractingRemoval);
+}
+
+void UGSAbilitySystemComponent::NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability)
+{
+	Super::NotifyAbilityActivated(Handle, Ability);
+
+	if (PendingAbilityInputEdges.Num() == 0)
+	{
+		return;
+	}
+
+	// Edges queued for the other specs bound to this input were meant for this activation
+	const FGameplayAbilitySpec* ActivatedSpec = FindAbilitySpecFromHandle(Handle);
+	if (ActivatedSpec && ActivatedSpec->InputID != INDEX_NONE)
+	{
+		PendingAbilityInputEdges.RemoveAll([this, Handle, InputID = ActivatedSpec->InputID](const FPendingAbilityInputEdge& Edge)
+		{
+			const FGameplayAbilitySpec* Spec = Edge.Handle != Handle ? FindAbilitySpecFromHandle(Edge.Handle) : nullptr;
+			return Spec && Spec->InputID == InputID;
+		});
+	}
+
+	// Queued move edges go out next tick, after ActivateAbility has set up whatever listens for them
+	if (PendingAbilityInputEdges.ContainsByPredicate([Handle](const FPendingAbilityInputEdge& Edge) { return Edge.Handle == Handle; }))
+	{
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UGSAbilitySystemComponent::ApplyPendingAbilityInputEdges);
+	}
+}
+
+void UGSAbilitySystemComponent::NotifyAbilityFailed(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason)
+{
+	Super::NotifyAbilityFailed(Handle, Ability, FailureReason);
+
+	// The activation the edges were waiting for was rejected
+	PendingAbilityInputEdges.RemoveAll([Handle](const FPendingAbilityInputEdge& Edge) { return Edge.Handle == Handle; });
 }
 
 void UGSAbilitySystemComponent::NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled)
@@ -86,6 +391,11 @@ UGSAbilitySystemComponent* UGSAbilitySystemComponent::GetAbilitySystemComponentF
 
 void UGSAbilitySystemComponent::AbilityLocalInputPressed(int32 InputID)
 {
+	if (InputID >= 0 && InputID < 16)
+	{
+		LocalAbilityInputMask |= (1 << InputID);
+	}
+
 	// Consume the input if this InputID is overloaded with GenericConfirm/Cancel and the GenericConfim/Cancel callback is bound
 	if (IsGenericConfirmInputBound(InputID))
 	{
@@ -101,6 +411,9 @@ void UGSAbilitySystemComponent::AbilityLocalInputPressed(int32 InputID)
 
 	// ---------------------------------------------------------
 
+	// Only InputIDs that fit the move masks can go in moves
+	const bool bInputInMoves = InputID >= 0 && InputID < 16 && ShouldReplicateInputInMoves();
+
 	ABILITYLIST_SCOPE_LOCK();
 	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
 	{
@@ -113,7 +426,15 @@ void UGSAbilitySystemComponent::AbilityLocalInputPressed(int32 InputID)
 				{
 					if (Spec.Ability->bReplicateInputDirectly && IsOwnerActorAuthoritative() == false)
 					{
-						ServerSetInputPressed(Spec.Handle);
+						if (bInputInMoves)
+						{
+							LocalAbilityInputPressedEdges |= (1 << InputID);
+						}
+						else
+						{
+							FlushPendingAbilityRPCBatches();
+							ServerSetInputPressed(Spec.Handle);
+						}
 					}
 
 					AbilitySpecInputPressed(Spec);
@@ -135,11 +456,377 @@ void UGSAbilitySystemComponent::AbilityLocalInputPressed(int32 InputID)
 	}
 }
 
+void UGSAbilitySystemComponent::AbilityLocalInputReleased(int32 InputID)
+{
+	if (InputID >= 0 && InputID < 16)
+	{
+		LocalAbilityInputMask &= ~(1 << InputID);
+	}
+
+	// Same as the engine version, except the edge goes in the next move when moves carry the input
+	const bool bInputInMoves = InputID >= 0 && InputID < 16 && ShouldReplicateInputInMoves();
+
+	ABILITYLIST_SCOPE_LOCK();
+	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	{
+		if (Spec.InputID == InputID)
+		{
+			Spec.InputPressed = false;
+			if (Spec.Ability && Spec.IsActive())
+			{
+				if (Spec.Ability->bReplicateInputDirectly && IsOwnerActorAuthoritative() == false)
+				{
+					if (bInputInMoves)
+					{
+						LocalAbilityInputReleasedEdges |= (1 << InputID);
+					}
+					else
+					{
+						FlushPendingAbilityRPCBatches();
+						ServerSetInputReleased(Spec.Handle);
+					}
+				}
+
+				AbilitySpecInputReleased(Spec);
+
+				InvokeReplicatedEvent(EAbilityGenericReplicatedEvent::InputReleased, Spec.Handle, Spec.ActivationInfo.GetActivationPredictionKey());
+			}
+		}
+	}
+}
+
+void UGSAbilitySystemComponent::ConsumeLocalAbilityInputEdges(uint16& OutPressedEdges, uint16& OutReleasedEdges)
+{
+	OutPressedEdges = LocalAbilityInputPressedEdges;
+	OutReleasedEdges = LocalAbilityInputReleasedEdges;
+	LocalAbilityInputPressedEdges = 0;
+	LocalAbilityInputReleasedEdges = 0;
+}
+
+void UGSAbilitySystemComponent::ServerApplyAbilityInputEdges(uint16 PressedEdges, uint16 ReleasedEdges, uint16 HeldMask)
+{
+	const uint16 EdgeBits = PressedEdges | ReleasedEdges;
+	if (EdgeBits == 0)
+	{
+		return;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// The client only sends edges for inputs with an active spec. Where one is already active here, that's the spec.
+	uint16 ActiveBits = 0;
+	for (const FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	{
+		if (Spec.InputID >= 0 && Spec.InputID < 16 && Spec.IsActive())
+		{
+			ActiveBits |= 1 << Spec.InputID;
+		}
+	}
+
+	ABILITYLIST_SCOPE_LOCK();
+	for (FGameplayAbilitySpec& Spec : ActivatableAbilities.Items)
+	{
+		if (Spec.InputID < 0 || Spec.InputID >= 16 || !(EdgeBits & (1 << Spec.InputID)) || !Spec.Ability || !Spec.Ability->bReplicateInputDirectly)
+		{
+			continue;
+		}
+
+		if ((ActiveBits & (1 << Spec.InputID)) && !Spec.IsActive())
+		{
+			continue;
+		}
+
+		const uint16 Bit = 1 << Spec.InputID;
+		const bool bPressed = (PressedEdges & Bit) != 0;
+		const bool bReleased = (ReleasedEdges & Bit) != 0;
+		if (bPressed && bReleased)
+		{
+			// Both in one move. Still held at the end means it was released, then pressed again.
+			const bool bHeld = (HeldMask & Bit) != 0;
+			ServerApplyAbilityInputEdge(Spec, !bHeld, Now);
+			ServerApplyAbilityInputEdge(Spec, bHeld, Now);
+		}
+		else
+		{
+			ServerApplyAbilityInputEdge(Spec, bPressed, Now);
+		}
+	}
+}
+
+void UGSAbilitySystemComponent::ServerApplyAbilityInputEdge(FGameplayAbilitySpec& Spec, bool bPressed, double QueuedTime)
+{
+	// The client only sends edges for active specs, so an inactive one here is still waiting on its activation RPC
+	if (!Spec.IsActive())
+	{
+		// Activations that never arrive or never notify would otherwise leave their edges behind
+		const double Now = GetWorld()->GetTimeSeconds();
+		PendingAbilityInputEdges.RemoveAll([Now](const FPendingAbilityInputEdge& Edge) { return Now - Edge.QueuedTime > PendingAbilityInputEdgeTimeout; });
+		PendingAbilityInputEdges.Add({ Spec.Handle, bPressed, QueuedTime });
+		return;
+	}
+
+	// What ServerSetInputPressed/Released would have done
+	if (bPressed)
+	{
+		AbilitySpecInputPressed(Spec);
+	}
+	else
+	{
+		AbilitySpecInputReleased(Spec);
+	}
+}
+
+void UGSAbilitySystemComponent::ApplyPendingAbilityInputEdges()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	TArray<FPendingAbilityInputEdge> Edges = MoveTemp(PendingAbilityInputEdges);
+
+	ABILITYLIST_SCOPE_LOCK();
+	for (const FPendingAbilityInputEdge& Edge : Edges)
+	{
+		// Activation was rejected or the ability already ended, same as an RPC for an inactive spec
+		if (Now - Edge.QueuedTime > PendingAbilityInputEdgeTimeout)
+		{
+			continue;
+		}
+
+		FGameplayAbilitySpec* Spec = FindAbilitySpecFromHandle(Edge.Handle);
+		if (!Spec)
+		{
+			continue;
+		}
+
+		// Still inactive edges are queued again in order
+		ServerApplyAbilityInputEdge(*Spec, Edge.bPressed, Edge.QueuedTime);
+	}
+}
+
+bool UGSAbilitySystemComponent::ShouldReplicateInputInMoves() const
+{
+	if (!CVarAbilityInputInMoves.GetValueOnGameThread())
+	{
+		return false;
+	}
+
+	const ACharacter* Character = Cast<ACharacter>(GetAvatarActor_Direct());
+	return Character && Cast<UGSCharacterMovementComponent>(Character->GetCharacterMovement());
+}
+
 int32 UGSAbilitySystemComponent::K2_GetTagCount(FGameplayTag TagToCheck) const
 {
 	return GetTagCount(TagToCheck);
 }
 
+float UGSAbilitySystemComponent::GetCooldownRemaining(FGameplayTag CooldownTag) const
+{
+	float TimeRemaining = 0.0f;
+	float Duration = 0.0f;
+	GetCooldownRemainingAndDuration(CooldownTag, TimeRemaining, Duration);
+	return TimeRemaining;
+}
+
+bool UGSAbilitySystemComponent::GetCooldownRemainingAndDuration(FGameplayTag CooldownTag, float& TimeRemaining, float& Duration) const
+{
+	TimeRemaining = 0.0f;
+	Duration = 0.0f;
+
+	const FGSCooldownCacheEntry* Entry = CooldownCache.Find(CooldownTag);
+	UWorld* World = GetWorld();
+	if (!Entry || !World)
+	{
+		return false;
+	}
+
+	TimeRemaining = FMath::Max(Entry->EndTime - World->GetTimeSeconds(), 0.0f);
+	Duration = Entry->Duration;
+	return TimeRemaining > 0.0f;
+}
+
+void UGSAbilitySystemComponent::OnCooldownEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle)
+{
+	if (!SpecApplied.Def || SpecApplied.Def->DurationPolicy != EGameplayEffectDurationType::HasDuration)
+	{
+		return;
+	}
+
+	if (FOnActiveGameplayEffectStackChange* StackChangeDelegate = OnGameplayEffectStackChangeDelegate(ActiveHandle))
+	{
+		StackChangeDelegate->AddUObject(this, &UGSAbilitySystemComponent::OnCooldownEffectStackChanged);
+	}
+
+	if (FOnActiveGameplayEffectTimeChange* TimeChangeDelegate = OnGameplayEffectTimeChangeDelegate(ActiveHandle))
+	{
+		TimeChangeDelegate->AddUObject(this, &UGSAbilitySystemComponent::OnCooldownEffectTimeChanged);
+	}
+
+	FGameplayTagContainer GrantedTags;
+	SpecApplied.GetAllGrantedTags(GrantedTags);
+	UpdateCooldownCache(GrantedTags);
+}
+
+void UGSAbilitySystemComponent::OnCooldownEffectRemoved(const FActiveGameplayEffect& RemovedEffect)
+{
+	if (!RemovedEffect.Spec.Def || RemovedEffect.Spec.Def->DurationPolicy != EGameplayEffectDurationType::HasDuration)
+	{
+		return;
+	}
+
+	FGameplayTagContainer GrantedTags;
+	RemovedEffect.Spec.GetAllGrantedTags(GrantedTags);
+	UpdateCooldownCache(GrantedTags, RemovedEffect.Handle);
+}
+
+void UGSAbilitySystemComponent::OnCooldownEffectStackChanged(FActiveGameplayEffectHandle ActiveHandle, int32 NewStackCount, int32 PreviousStackCount)
+{
+	// Stacking can refresh the duration
+	if (const FActiveGameplayEffect* ActiveEffect = GetActiveGameplayEffect(ActiveHandle))
+	{
+		FGameplayTagContainer GrantedTags;
+		ActiveEffect->Spec.GetAllGrantedTags(GrantedTags);
+		UpdateCooldownCache(GrantedTags);
+	}
+}
+
+void UGSAbilitySystemComponent::OnCooldownEffectTimeChanged(FActiveGameplayEffectHandle ActiveHandle, float NewStartTime, float NewDuration)
+{
+	if (const FActiveGameplayEffect* ActiveEffect = GetActiveGameplayEffect(ActiveHandle))
+	{
+		FGameplayTagContainer GrantedTags;
+		ActiveEffect->Spec.GetAllGrantedTags(GrantedTags);
+		UpdateCooldownCache(GrantedTags);
+	}
+}
+
+void UGSAbilitySystemComponent::UpdateCooldownCache(const FGameplayTagContainer& Tags, FActiveGameplayEffectHandle IgnoreHandle)
+{
+	for (const FGameplayTag& Tag : Tags)
+	{
+		// Only scans when an effect changes, not when the HUD asks
+		FGameplayEffectQuery Query = FGameplayEffectQuery::MakeQuery_MatchAnyOwningTags(FGameplayTagContainer(Tag));
+		if (IgnoreHandle.IsValid())
+		{
+			Query.IgnoreHandles.Add(IgnoreHandle);
+		}
+
+		TArray<TPair<float, float>> TimesAndDurations = GetActiveEffectsTimeRemainingAndDuration(Query);
+
+		const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0f;
+		FGSCooldownCacheEntry Longest;
+		bool bFound = false;
+		for (const TPair<float, float>& TimeAndDuration : TimesAndDurations)
+		{
+			// Infinite effects report -1 and aren't cooldowns
+			if (TimeAndDuration.Key > 0.0f && Now + TimeAndDuration.Key > Longest.EndTime)
+			{
+				Longest.EndTime = Now + TimeAndDuration.Key;
+				Longest.Duration = TimeAndDuration.Value;
+				bFound = true;
+			}
+		}
+
+		if (bFound)
+		{
+			CooldownCache.Add(Tag, Longest);
+		}
+		else
+		{
+			CooldownCache.Remove(Tag);
+		}
+	}
+}
+
+void UGSAbilitySystemComponent::GiveAbilitiesBatched(const TArray<FGameplayAbilitySpec>& Specs, TArray<FGameplayAbilitySpecHandle>& OutHandles)
+{
+	if (!IsOwnerActorAuthoritative())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() called on %s with no authority"), *FString(__FUNCTION__), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	OutHandles.Reserve(OutHandles.Num() + Specs.Num());
+
+	// GiveAbility already knows how to defer adds while the list is being iterated
+	if (AbilityScopeLockCount > 0)
+	{
+		for (const FGameplayAbilitySpec& Spec : Specs)
+		{
+			OutHandles.Add(GiveAbility(Spec));
+		}
+		return;
+	}
+
+	{
+		// OnGiveAbility can give or clear other abilities. Those are deferred so our references stay valid.
+		ABILITYLIST_SCOPE_LOCK();
+
+		ActivatableAbilities.Items.Reserve(ActivatableAbilities.Items.Num() + Specs.Num());
+		for (const FGameplayAbilitySpec& Spec : Specs)
+		{
+			if (!IsValid(Spec.Ability))
+			{
+				continue;
+			}
+
+			FGameplayAbilitySpec& OwnedSpec = ActivatableAbilities.Items.Add_GetRef(Spec);
+			if (OwnedSpec.Ability->GetInstancingPolicy() == EGameplayAbilityInstancingPolicy::InstancedPerActor)
+			{
+				CreateNewInstanceOfAbility(OwnedSpec, Spec.Ability);
+			}
+
+			OnGiveAbility(OwnedSpec);
+
+			// Same as GiveAbility: the new item needs its own replication ID and listeners expect one callback per spec
+			MarkAbilitySpecDirty(OwnedSpec, true);
+			OutHandles.Add(OwnedSpec.Handle);
+		}
+	}
+}
+
+void UGSAbilitySystemComponent::ClearAbilitiesBatched(const TArray<FGameplayAbilitySpecHandle>& Handles)
+{
+	if (!IsOwnerActorAuthoritative() || Handles.Num() == 0)
+	{
+		return;
+	}
+
+	if (AbilityScopeLockCount > 0)
+	{
+		for (const FGameplayAbilitySpecHandle& Handle : Handles)
+		{
+			ClearAbility(Handle);
+		}
+		return;
+	}
+
+	const TSet<FGameplayAbilitySpecHandle> HandlesToClear(Handles);
+	bool bRemovedAny = false;
+
+	{
+		// OnRemoveAbility can end the ability, which can do anything to the list
+		ABILITYLIST_SCOPE_LOCK();
+
+		for (int32 Idx = ActivatableAbilities.Items.Num() - 1; Idx >= 0; --Idx)
+		{
+			if (HandlesToClear.Contains(ActivatableAbilities.Items[Idx].Handle))
+			{
+				OnRemoveAbility(ActivatableAbilities.Items[Idx]);
+				ActivatableAbilities.Items.RemoveAtSwap(Idx);
+				bRemovedAny = true;
+			}
+		}
+
+		if (bRemovedAny)
+		{
+			ActivatableAbilities.MarkArrayDirty();
+		}
+	}
+
+	if (bRemovedAny)
+	{
+		CheckForClearedAbilities();
+	}
+}
+
 FGameplayAbilitySpecHandle UGSAbilitySystemComponent::FindAbilitySpecHandleForClass(TSubclassOf<UGameplayAbility> AbilityClass, UObject* OptionalSourceObject)
 {
 	ABILITYLIST_SCOPE_LOCK();
@@ -202,6 +889,200 @@ bool UGSAbilitySystemComponent::BatchRPCTryActivateAbility(FGameplayAbilitySpecH
 	return AbilityActivated;
 }
 
+bool UGSAbilitySystemComponent::BatchRPCTryActivateAbilities(const TArray<FGameplayAbilitySpecHandle>& InAbilityHandles, bool EndAbilitiesImmediately)
+{
+	FGSScopedAbilityRPCMultiBatcher MultiBatcher(this);
+
+	bool AnyActivated = false;
+	for (const FGameplayAbilitySpecHandle& Handle : InAbilityHandles)
+	{
+		AnyActivated |= BatchRPCTryActivateAbility(Handle, EndAbilitiesImmediately);
+	}
+
+	return AnyActivated;
+}
+
+void UGSAbilitySystemComponent::OpenAbilityRPCBatchWindow()
+{
+	UWorld* World = GetWorld();
+	if (AbilityRPCBatchWindowHandle.IsValid() || IsOwnerActorAuthoritative() || !World)
+	{
+		return;
+	}
+
+	BeginAbilityRPCMultiBatch();
+	AbilityRPCBatchWindowHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UGSAbilitySystemComponent::OnAbilityRPCBatchWindowEnd);
+}
+
+void UGSAbilitySystemComponent::OnAbilityRPCBatchWindowEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	FWorldDelegates::OnWorldPostActorTick.Remove(AbilityRPCBatchWindowHandle);
+	AbilityRPCBatchWindowHandle.Reset();
+	EndAbilityRPCMultiBatch();
+}
+
+void UGSAbilitySystemComponent::BeginAbilityRPCMultiBatch()
+{
+	++AbilityRPCMultiBatchDepth;
+}
+
+void UGSAbilitySystemComponent::EndAbilityRPCMultiBatch()
+{
+	if (!ensure(AbilityRPCMultiBatchDepth > 0) || --AbilityRPCMultiBatchDepth > 0)
+	{
+		return;
+	}
+
+	FlushPendingAbilityRPCBatches();
+}
+
+void UGSAbilitySystemComponent::FlushPendingAbilityRPCBatches()
+{
+	if (PendingAbilityRPCBatches.Num() == 0)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_GSAbilityRPCBatchesSent);
+	INC_DWORD_STAT_BY(STAT_GSAbilityRPCBatchesMerged, PendingAbilityRPCBatches.Num());
+
+	// A single batch goes through the engine RPC unchanged
+	if (PendingAbilityRPCBatches.Num() == 1)
+	{
+		ServerAbilityRPCBatch(PendingAbilityRPCBatches[0]);
+		PendingAbilityRPCBatches.Reset();
+		RecordAbilityRPCs(1, 1);
+		return;
+	}
+
+	const int32 MaxBatchesPerRPC = FMath::Clamp(CVarAbilityRPCMaxBatchesPerRPC.GetValueOnGameThread(), 1, MaxAbilityRPCBatchesPerRPC);
+	int32 NumRPCs = 0;
+	for (int32 Start = 0; Start < PendingAbilityRPCBatches.Num(); Start += MaxBatchesPerRPC)
+	{
+		const int32 Count = FMath::Min(MaxBatchesPerRPC, PendingAbilityRPCBatches.Num() - Start);
+		ServerAbilityRPCMultiBatch(TArray<FServerAbilityRPCBatch>(PendingAbilityRPCBatches.GetData() + Start, Count));
+		++NumRPCs;
+	}
+
+	RecordAbilityRPCs(NumRPCs, PendingAbilityRPCBatches.Num());
+	PendingAbilityRPCBatches.Reset();
+}
+
+void UGSAbilitySystemComponent::RecordAbilityRPCs(int32 NumRPCs, int32 NumBatches)
+{
+	AbilityRPCsSent += NumRPCs;
+	AbilityRPCBatchesSent += NumBatches;
+
+	const UWorld* World = GetWorld();
+	if (!World || CVarAbilityRPCLogStats.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	const double Now = World->GetRealTimeSeconds();
+	if (Now - AbilityRPCStatsWindowStart < 1.0)
+	{
+		return;
+	}
+
+	if (AbilityRPCStatsWindowStart > 0.0)
+	{
+		const double WindowSeconds = Now - AbilityRPCStatsWindowStart;
+		UE_LOG(LogTemp, Log, TEXT("%s() %s: %.1f ability batch RPCs/s carrying %.1f batches/s"), *FString(__FUNCTION__), *GetNameSafe(GetOwner()),
+			(AbilityRPCsSent - AbilityRPCsSentAtWindowStart) / WindowSeconds, (AbilityRPCBatchesSent - AbilityRPCBatchesSentAtWindowStart) / WindowSeconds);
+	}
+
+	AbilityRPCStatsWindowStart = Now;
+	AbilityRPCsSentAtWindowStart = AbilityRPCsSent;
+	AbilityRPCBatchesSentAtWindowStart = AbilityRPCBatchesSent;
+}
+
+void UGSAbilitySystemComponent::CallServerTryActivateAbility(FGameplayAbilitySpecHandle AbilityToActivate, bool InputPressed, FPredictionKey PredictionKey)
+{
+	FlushPendingAbilityRPCBatchesBeforeRPC(AbilityToActivate);
+	Super::CallServerTryActivateAbility(AbilityToActivate, InputPressed, PredictionKey);
+}
+
+void UGSAbilitySystemComponent::CallServerSetReplicatedTargetData(FGameplayAbilitySpecHandle AbilityHandle, FPredictionKey AbilityOriginalPredictionKey, const FGameplayAbilityTargetDataHandle& ReplicatedTargetDataHandle, FGameplayTag ApplicationTag, FPredictionKey CurrentPredictionKey)
+{
+	FlushPendingAbilityRPCBatchesBeforeRPC(AbilityHandle);
+	Super::CallServerSetReplicatedTargetData(AbilityHandle, AbilityOriginalPredictionKey, ReplicatedTargetDataHandle, ApplicationTag, CurrentPredictionKey);
+}
+
+void UGSAbilitySystemComponent::CallServerEndAbility(FGameplayAbilitySpecHandle AbilityToEnd, FGameplayAbilityActivationInfo ActivationInfo, FPredictionKey PredictionKey)
+{
+	FlushPendingAbilityRPCBatchesBeforeRPC(AbilityToEnd);
+	Super::CallServerEndAbility(AbilityToEnd, ActivationInfo, PredictionKey);
+}
+
+void UGSAbilitySystemComponent::FlushPendingAbilityRPCBatchesBeforeRPC(FGameplayAbilitySpecHandle AbilityHandle)
+{
+	// Calls for an ability with an open batch go into that batch, which keeps its place in the queue
+	if (AbilityHandle.IsValid() && LocalServerAbilityRPCBatchData.ContainsByKey(AbilityHandle))
+	{
+		return;
+	}
+
+	// Anything sent on its own must not overtake batches that were made before it
+	FlushPendingAbilityRPCBatches();
+}
+
+void UGSAbilitySystemComponent::EndServerAbilityRPCBatch(FGameplayAbilitySpecHandle AbilityHandle)
+{
+	if (AbilityRPCMultiBatchDepth == 0)
+	{
+		const bool bSends = LocalServerAbilityRPCBatchData.ContainsByPredicate([AbilityHandle](const FServerAbilityRPCBatch& Batch) { return Batch.AbilitySpecHandle == AbilityHandle && Batch.Started; });
+		Super::EndServerAbilityRPCBatch(AbilityHandle);
+		if (bSends)
+		{
+			RecordAbilityRPCs(1, 1);
+		}
+		return;
+	}
+
+	// Same as the engine version, except the batch is queued instead of sent
+	const int32 Index = LocalServerAbilityRPCBatchData.IndexOfByKey(AbilityHandle);
+	if (Index == INDEX_NONE)
+	{
+		ABILITY_LOG(Error, TEXT("EndServerAbilityRPCBatch called on ability %s when no batch has been started."), *AbilityHandle.ToString());
+		return;
+	}
+
+	FServerAbilityRPCBatch ThisBatch = LocalServerAbilityRPCBatchData[Index];
+	LocalServerAbilityRPCBatchData.RemoveAt(Index);
+
+	if (ThisBatch.Started)
+	{
+		if (!ThisBatch.TargetData.IsValid())
+		{
+			ThisBatch.TargetData = FGameplayAbilityTargetDataHandle();
+		}
+
+		PendingAbilityRPCBatches.Add(MoveTemp(ThisBatch));
+	}
+}
+
+bool UGSAbilitySystemComponent::ServerAbilityRPCMultiBatch_Validate(const TArray<FServerAbilityRPCBatch>& Batches)
+{
+	// Not the CVar, it can differ between client and server
+	return Batches.Num() > 0 && Batches.Num() <= MaxAbilityRPCBatchesPerRPC;
+}
+
+void UGSAbilitySystemComponent::ServerAbilityRPCMultiBatch_Implementation(const TArray<FServerAbilityRPCBatch>& Batches)
+{
+	// In client order, each with its own prediction key, exactly as if the batches had arrived one RPC at a time
+	for (const FServerAbilityRPCBatch& Batch : Batches)
+	{
+		FServerAbilityRPCBatch BatchCopy = Batch;
+		ServerAbilityRPCBatch_Internal(BatchCopy);
+	}
+}
+
 void UGSAbilitySystemComponent::ExecuteGameplayCueLocal(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters)
 {
 	UAbilitySystemGlobals::Get().GetGameplayCueManager()->HandleGameplayCue(GetOwner(), GameplayCueTag, EGameplayCueEvent::Type::Executed, GameplayCueParameters);
@@ -428,6 +1309,7 @@ void UGSAbilitySystemComponent::CurrentMontageJumpToSectionForMesh(USkeletalMesh
 		}
 		else
 		{
+			FlushPendingAbilityRPCBatches();
 			ServerCurrentMontageJumpToSectionNameForMesh(InMesh, AnimMontageInfo.LocalMontageInfo.AnimMontage, SectionName);
 		}
 	}
@@ -450,6 +1332,7 @@ void UGSAbilitySystemComponent::CurrentMontageSetNextSectionNameForMesh(USkeleta
 		else
 		{
 			float CurrentPosition = AnimInstance->Montage_GetPosition(AnimMontageInfo.LocalMontageInfo.AnimMontage);
+			FlushPendingAbilityRPCBatches();
 			ServerCurrentMontageSetNextSectionNameForMesh(InMesh, AnimMontageInfo.LocalMontageInfo.AnimMontage, CurrentPosition, FromSectionName, ToSectionName);
 		}
 	}
@@ -471,6 +1354,7 @@ void UGSAbilitySystemComponent::CurrentMontageSetPlayRateForMesh(USkeletalMeshCo
 		}
 		else
 		{
+			FlushPendingAbilityRPCBatches();
 			ServerCurrentMontageSetPlayRateForMesh(InMesh, AnimMontageInfo.LocalMontageInfo.AnimMontage, InPlayRate);
 		}
 	}
@@ -611,6 +1495,41 @@ float UGSAbilitySystemComponent::GetCurrentMontageSectionTimeLeftForMesh(USkelet
 	return -1.f;
 }
 
+void UGSAbilitySystemComponent::ResetForReuse()
+{
+	CancelAllAbilities();
+	StopAllCurrentMontages(0.0f);
+
+	LocalAnimMontageInfoForMeshes.Reset();
+	RepAnimMontageInfoForMeshes.Reset();
+	bPendingMontageRepForMesh = false;
+
+	if (IsOwnerActorAuthoritative())
+	{
+		RemoveActiveEffects(FGameplayEffectQuery());
+	}
+
+	// With effects and abilities gone, whatever is left is loose (State.Dead etc.)
+	FGameplayTagContainer LooseTags;
+	GetOwnedGameplayTags(LooseTags);
+	for (const FGameplayTag& Tag : LooseTags)
+	{
+		SetLooseGameplayTagCount(Tag, 0);
+	}
+
+	CooldownCache.Reset();
+	bStartupEffectsApplied = false;
+
+	LocalAbilityInputMask = 0;
+	LocalAbilityInputPressedEdges = 0;
+	LocalAbilityInputReleasedEdges = 0;
+	PendingAbilityInputEdges.Reset();
+
+	// The next life equips its weapon again
+	CurrentWeaponSource = nullptr;
+	bHasCurrentWeaponSource = false;
+}
+
 FGameplayAbilityLocalAnimMontageForMesh& UGSAbilitySystemComponent::GetLocalAnimMontageInfoForMesh(USkeletalMeshComponent* InMesh)
 {
 	for (FGameplayAbilityLocalAnimMontageForMesh& MontageInfo : LocalAnimMontageInfoForMeshes)
@@ -753,6 +1672,12 @@ void UGSAbilitySystemComponent::OnRep_ReplicatedAnimMontageForMesh()
 
 		if (!AbilityActorInfo->IsLocallyControlled())
 		{
+			// Replicated montages are fire/reload/melee, keep this character significant while it fights
+			if (AVTCharacterBase* AvatarCharacter = Cast<AVTCharacterBase>(AbilityActorInfo->AvatarActor.Get()))
+			{
+				AvatarCharacter->NotifyCombatActivity();
+			}
+
 			static const auto CVar = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("net.Montage.Debug"));
 			bool DebugMontage = (CVar && CVar->GetValueOnGameThread() == 1);
 			if (DebugMontage)
@@ -955,3 +1880,20 @@ bool UGSAbilitySystemComponent::ServerCurrentMontageSetPlayRateForMesh_Validate(
 {
 	return true;
 }
+
+FGSScopedAbilityRPCMultiBatcher::FGSScopedAbilityRPCMultiBatcher(UGSAbilitySystemComponent* InASC)
+	: ASC(InASC)
+{
+	if (ASC.IsValid())
+	{
+		ASC->BeginAbilityRPCMultiBatch();
+	}
+}
+
+FGSScopedAbilityRPCMultiBatcher::~FGSScopedAbilityRPCMultiBatcher()
+{
+	if (ASC.IsValid())
+	{
+		ASC->EndAbilityRPCMultiBatch();
+	}
+}
@@ -3,6 +3,9 @@
 
 #include "Characters/Abilities/GSAbilitySystemGlobals.h"
 #include "Characters/Abilities/GSGameplayEffectTypes.h"
+#include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
+#include "Engine/DataTable.h"
+#include "VTGameplayTags.h"
 
 UGSAbilitySystemGlobals::UGSAbilitySystemGlobals()
 {
@@ -18,8 +21,25 @@ void UGSAbilitySystemGlobals::InitGlobalTags()
 {
 	Super::InitGlobalTags();
 
-	DeadTag = FGameplayTag::RequestGameplayTag("State.Dead");
-	KnockedDownTag = FGameplayTag::RequestGameplayTag("State.KnockedDown");
-	InteractingTag = FGameplayTag::RequestGameplayTag("State.Interacting");
-	InteractingRemovalTag = FGameplayTag::RequestGameplayTag("State.InteractingRemoval");
+	DeadTag = VTGameplayTags::State_Dead;
+	KnockedDownTag = VTGameplayTags::State_KnockedDown;
+	InteractingTag = VTGameplayTags::State_Interacting;
+	InteractingRemovalTag = VTGameplayTags::State_InteractingRemoval;
+}
+
+void UGSAbilitySystemGlobals::InitGlobalData()
+{
+	Super::InitGlobalData();
+
+	const UDataTable* AmmoTypeTable = nullptr;
+	if (AmmoTypeTableName.IsValid())
+	{
+		AmmoTypeTable = Cast<UDataTable>(AmmoTypeTableName.TryLoad());
+		if (!AmmoTypeTable)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s() Could not load AmmoTypeTableName %s"), *FString(__FUNCTION__), *AmmoTypeTableName.ToString());
+		}
+	}
+
+	UGSAmmoAttributeSet::InitAmmoTypes(AmmoTypeTable);
 }
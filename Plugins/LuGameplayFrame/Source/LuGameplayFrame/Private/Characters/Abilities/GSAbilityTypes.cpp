@@ -15,8 +15,15 @@ bool FGSGameplayEffectContainerSpec::HasValidTargets() const
 	return TargetData.Num() > 0;
 }
 
-void FGSGameplayEffectContainerSpec::AddTargets(const TArray<FGameplayAbilityTargetDataHandle>& InTargetData, const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors)
+void FGSGameplayEffectContainerSpec::AddTargets(TArrayView<const FGameplayAbilityTargetDataHandle> InTargetData, TArrayView<const FHitResult> HitResults, TArrayView<AActor* const> TargetActors)
 {
+	int32 NumNewData = HitResults.Num() + (TargetActors.Num() > 0 ? 1 : 0);
+	for (const FGameplayAbilityTargetDataHandle& TD : InTargetData)
+	{
+		NumNewData += TD.Num();
+	}
+	TargetData.Data.Reserve(TargetData.Num() + NumNewData);
+
 	for (const FGameplayAbilityTargetDataHandle& TD : InTargetData)
 	{
 		TargetData.Append(TD);
@@ -31,7 +38,11 @@ void FGSGameplayEffectContainerSpec::AddTargets(const TArray<FGameplayAbilityTar
 	if (TargetActors.Num() > 0)
 	{
 		FGameplayAbilityTargetData_ActorArray* NewData = new FGameplayAbilityTargetData_ActorArray();
-		NewData->TargetActorArray.Append(TargetActors);
+		NewData->TargetActorArray.Reserve(TargetActors.Num());
+		for (AActor* TargetActor : TargetActors)
+		{
+			NewData->TargetActorArray.Add(TargetActor);
+		}
 		TargetData.Add(NewData);
 	}
 }
@@ -3,16 +3,39 @@
 
 #include "Characters/Abilities/GSGameplayAbility.h"
 #include "AbilitySystemComponent.h"
+#include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
 #include "Characters/Abilities/GSAbilitySystemComponent.h"
 #include "Characters/Abilities/GSAbilitySystemGlobals.h"
 #include "Characters/Abilities/GSTargetType.h"
 #include "Characters/VTCharacterBase.h"
 #include "Characters/Heroes/GSHeroCharacter.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameplayTagContainer.h"
 #include "GSBlueprintFunctionLibrary.h"
+#include "LuGameplayFrame.h"
 #include "Player/GSPlayerController.h"
+#include "TimerManager.h"
+#include "VTGameplayTags.h"
 #include "Weapons/GSWeapon.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blueprint Cost Calls"), STAT_GSBlueprintCostCalls, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Stream Shots Sent"), STAT_GSFireStreamShots, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fire Stream Payloads Sent"), STAT_GSFireStreamPayloads, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<int32> CVarFireStreamMaxCoalesceFrames(
+	TEXT("VT.FireStream.MaxCoalesceFrames"),
+	3,
+	TEXT("Upper bound on FireStreamCoalesceFrames for every ability. 0 sends every shot on its own.")
+);
+
+static TAutoConsoleVariable<int32> CVarFireStreamMaxShots(
+	TEXT("VT.FireStream.MaxShotsPerPayload"),
+	8,
+	TEXT("A coalesced fire stream payload is sent early once it holds this many shots")
+);
+
 UGSGameplayAbility::UGSGameplayAbility()
 {
 	// Default to Instance Per Actor
@@ -23,20 +46,38 @@ UGSGameplayAbility::UGSGameplayAbility()
 	bSourceObjectMustEqualCurrentWeaponToActivate = false;
 	bCannotActivateWhileInteracting = true;
 
-	// UGSAbilitySystemGlobals hasn't initialized tags yet to set ActivationBlockedTags
-	ActivationBlockedTags.AddTag(FGameplayTag::RequestGameplayTag("State.Dead"));
-	ActivationBlockedTags.AddTag(FGameplayTag::RequestGameplayTag("State.KnockedDown"));
+	// Native tags are registered at module load, so they are already valid for the CDO
+	ActivationBlockedTags.AddTag(VTGameplayTags::State_Dead);
+	ActivationBlockedTags.AddTag(VTGameplayTags::State_KnockedDown);
+
+	ActivationOwnedTags.AddTag(VTGameplayTags::Ability_BlocksInteraction);
 
-	ActivationOwnedTags.AddTag(FGameplayTag::RequestGameplayTag("Ability.BlocksInteraction"));
+	InteractingTag = VTGameplayTags::State_Interacting;
+	InteractingRemovalTag = VTGameplayTags::State_InteractingRemoval;
 
-	InteractingTag = FGameplayTag::RequestGameplayTag("State.Interacting");
-	InteractingRemovalTag = FGameplayTag::RequestGameplayTag("State.InteractingRemoval");
+	// Same check UGameplayAbility uses for its Blueprint events
+	auto ImplementedInBlueprint = [](const UFunction* Func) -> bool
+	{
+		return Func && ensure(Func->GetOuter()) && Func->GetOuter()->IsA(UBlueprintGeneratedClass::StaticClass());
+	};
+
+	static FName CheckCostFuncName = GET_FUNCTION_NAME_CHECKED(UGSGameplayAbility, GSCheckCost);
+	bHasBlueprintGSCheckCost = ImplementedInBlueprint(GetClass()->FindFunctionByName(CheckCostFuncName));
+
+	static FName ApplyCostFuncName = GET_FUNCTION_NAME_CHECKED(UGSGameplayAbility, GSApplyCost);
+	bHasBlueprintGSApplyCost = ImplementedInBlueprint(GetClass()->FindFunctionByName(ApplyCostFuncName));
 }
 
 void UGSGameplayAbility::OnAvatarSet(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilitySpec& Spec)
 {
 	Super::OnAvatarSet(ActorInfo, Spec);
 
+	// Non-instanced abilities run this on the CDO, which is shared by every spec
+	if (IsInstantiated())
+	{
+		GrantedSourceObject = Spec.SourceObject.Get();
+	}
+
 	if (bActivateAbilityOnGranted)
 	{
 		ActorInfo->AbilitySystemComponent->TryActivateAbility(Spec.Handle, false);
@@ -82,12 +123,10 @@ FGSGameplayEffectContainerSpec UGSGameplayAbility::MakeEffectContainerSpecFromCo
 		// If we have a target type, run the targeting logic. This is optional, targets can be added later
 		if (Container.TargetType.Get())
 		{
-			TArray<FHitResult> HitResults;
-			TArray<AActor*> TargetActors;
-			TArray<FGameplayAbilityTargetDataHandle> TargetData;
+			FGSTargetBuffers Targets;
 			const UGSTargetType* TargetTypeCDO = Container.TargetType.GetDefaultObject();
-			TargetTypeCDO->GetTargets(AvatarCharacter, AvatarActor, EventData, TargetData, HitResults, TargetActors);
-			ReturnSpec.AddTargets(TargetData, HitResults, TargetActors);
+			TargetTypeCDO->CollectTargets(AvatarCharacter, AvatarActor, EventData, Targets);
+			ReturnSpec.AddTargets(Targets.TargetData, Targets.HitResults, Targets.Actors);
 		}
 
 		// If we don't have an override level, use the ability level
@@ -98,6 +137,7 @@ FGSGameplayEffectContainerSpec UGSGameplayAbility::MakeEffectContainerSpecFromCo
 		}
 
 		// Build GameplayEffectSpecs for each applied effect
+		ReturnSpec.TargetGameplayEffectSpecs.Reserve(Container.TargetGameplayEffectClasses.Num());
 		for (const TSubclassOf<UGameplayEffect>& EffectClass : Container.TargetGameplayEffectClasses)
 		{
 			ReturnSpec.TargetGameplayEffectSpecs.Add(MakeOutgoingGameplayEffectSpec(EffectClass, OverrideGameplayLevel));
@@ -168,23 +208,41 @@ bool UGSGameplayAbility::IsPredictionKeyValidForMorePrediction() const
 
 bool UGSGameplayAbility::CanActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayTagContainer* SourceTags, const FGameplayTagContainer* TargetTags, OUT FGameplayTagContainer* OptionalRelevantTags) const
 {
+	const UGSAbilitySystemComponent* GSASC = Cast<UGSAbilitySystemComponent>(ActorInfo->AbilitySystemComponent.Get());
+
 	if (bCannotActivateWhileInteracting)
 	{
-		UAbilitySystemComponent* ASC = ActorInfo->AbilitySystemComponent.Get();
-		if (ASC->GetTagCount(InteractingTag) > ASC->GetTagCount(InteractingRemovalTag))
+		if (GSASC)
 		{
-			return false;
+			if (GSASC->IsInteracting())
+			{
+				return false;
+			}
+		}
+		else
+		{
+			UAbilitySystemComponent* ASC = ActorInfo->AbilitySystemComponent.Get();
+			if (ASC->GetTagCount(InteractingTag) > ASC->GetTagCount(InteractingRemovalTag))
+			{
+				return false;
+			}
 		}
 	}
 
 	if (bSourceObjectMustEqualCurrentWeaponToActivate)
 	{
-		AGSHeroCharacter* Hero = Cast<AGSHeroCharacter>(ActorInfo->AvatarActor);
-		if (Hero && Hero->GetCurrentWeapon() && (UObject*)Hero->GetCurrentWeapon() == GetSourceObject(Handle, ActorInfo))
+		UObject* CurrentWeapon = nullptr;
+		if (GSASC && GSASC->HasCurrentWeaponSource())
 		{
-			return Super::CanActivateAbility(Handle, ActorInfo, SourceTags, TargetTags, OptionalRelevantTags);
+			CurrentWeapon = GSASC->GetCurrentWeaponSource();
 		}
-		else
+		else if (AGSHeroCharacter* Hero = Cast<AGSHeroCharacter>(ActorInfo->AvatarActor))
+		{
+			CurrentWeapon = Hero->GetCurrentWeapon();
+		}
+
+		const UObject* SourceObject = (IsInstantiated() && Handle == CurrentSpecHandle) ? GrantedSourceObject.Get() : GetSourceObject(Handle, ActorInfo);
+		if (!CurrentWeapon || CurrentWeapon != SourceObject)
 		{
 			return false;
 		}
@@ -195,31 +253,117 @@ bool UGSGameplayAbility::CanActivateAbility(const FGameplayAbilitySpecHandle Han
 
 bool UGSGameplayAbility::CheckCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, OUT FGameplayTagContainer* OptionalRelevantTags) const
 {
-	return Super::CheckCost(Handle, ActorInfo, OptionalRelevantTags) && GSCheckCost(Handle, *ActorInfo);
+	if (!Super::CheckCost(Handle, ActorInfo, OptionalRelevantTags))
+	{
+		return false;
+	}
+
+	if (bHasBlueprintGSCheckCost)
+	{
+		INC_DWORD_STAT(STAT_GSBlueprintCostCalls);
+		return GSCheckCost(Handle, *ActorInfo);
+	}
+
+	// Native overrides still dispatch through the virtual, just not through ProcessEvent
+	return GSCheckCost_Implementation(Handle, *ActorInfo);
 }
 
 bool UGSGameplayAbility::GSCheckCost_Implementation(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo) const
 {
-	return true;
+	return CheckNativeCost(Handle, ActorInfo);
 }
 
 void UGSGameplayAbility::ApplyCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const
 {
-	GSApplyCost(Handle, *ActorInfo, ActivationInfo);
+	if (bHasBlueprintGSApplyCost)
+	{
+		INC_DWORD_STAT(STAT_GSBlueprintCostCalls);
+		GSApplyCost(Handle, *ActorInfo, ActivationInfo);
+	}
+	else
+	{
+		GSApplyCost_Implementation(Handle, *ActorInfo, ActivationInfo);
+	}
+
 	Super::ApplyCost(Handle, ActorInfo, ActivationInfo);
 }
 
+void UGSGameplayAbility::GSApplyCost_Implementation(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const
+{
+	ApplyNativeCost(Handle, ActorInfo);
+}
+
+bool UGSGameplayAbility::CheckNativeCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo) const
+{
+	switch (NativeCost.CostType)
+	{
+	case EGSAbilityCostType::WeaponClipAmmo:
+	{
+		const AGSWeapon* Weapon = Cast<AGSWeapon>(GetSourceObject(Handle, &ActorInfo));
+		return Weapon && (Weapon->HasInfiniteAmmo() || Weapon->GetPrimaryClipAmmo() >= NativeCost.Amount);
+	}
+	case EGSAbilityCostType::ReserveAmmo:
+	{
+		// The client's copy lags the server's unpredicted spends and refills, so the server decides
+		if (!ActorInfo.IsNetAuthority())
+		{
+			return true;
+		}
+
+		const UAbilitySystemComponent* ASC = ActorInfo.AbilitySystemComponent.Get();
+		const FGameplayAttribute Attribute = UGSAmmoAttributeSet::GetReserveAmmoAttributeForSlot(UGSAmmoAttributeSet::GetAmmoSlotForTag(NativeCost.AmmoTag));
+		return ASC && Attribute.IsValid() && ASC->GetNumericAttribute(Attribute) >= NativeCost.Amount;
+	}
+	default:
+		return true;
+	}
+}
+
+void UGSGameplayAbility::ApplyNativeCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo) const
+{
+	switch (NativeCost.CostType)
+	{
+	case EGSAbilityCostType::WeaponClipAmmo:
+	{
+		// Clip ammo is predicted, so the owning client spends it too
+		AGSWeapon* Weapon = Cast<AGSWeapon>(GetSourceObject(Handle, &ActorInfo));
+		if (Weapon && !Weapon->HasInfiniteAmmo())
+		{
+			Weapon->SetPrimaryClipAmmo(Weapon->GetPrimaryClipAmmo() - NativeCost.Amount);
+		}
+		break;
+	}
+	case EGSAbilityCostType::ReserveAmmo:
+	{
+		// Attributes can't be predicted without an effect, so only the server spends reserve ammo
+		UAbilitySystemComponent* ASC = ActorInfo.AbilitySystemComponent.Get();
+		const FGameplayAttribute Attribute = UGSAmmoAttributeSet::GetReserveAmmoAttributeForSlot(UGSAmmoAttributeSet::GetAmmoSlotForTag(NativeCost.AmmoTag));
+		if (ASC && Attribute.IsValid() && ActorInfo.IsNetAuthority())
+		{
+			ASC->ApplyModToAttribute(Attribute, EGameplayModOp::Additive, -NativeCost.Amount);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
 void UGSGameplayAbility::SetHUDReticle(TSubclassOf<UGSHUDReticle> ReticleClass)
 {
+	// Dedicated servers have no HUD
+#if !UE_SERVER
 	AGSPlayerController* PC = Cast<AGSPlayerController>(CurrentActorInfo->PlayerController);
 	if (PC)
 	{
 		PC->SetHUDReticle(ReticleClass);
 	}
+#endif
 }
 
 void UGSGameplayAbility::ResetHUDReticle()
 {
+#if !UE_SERVER
 	AGSPlayerController* PC = Cast<AGSPlayerController>(CurrentActorInfo->PlayerController);
 	if (PC)
 	{
@@ -233,21 +377,145 @@ void UGSGameplayAbility::ResetHUDReticle()
 			PC->SetHUDReticle(nullptr);
 		}
 	}
+#endif
 }
 
 void UGSGameplayAbility::SendTargetDataToServer(const FGameplayAbilityTargetDataHandle& TargetData)
 {
+	if (!IsPredictingClient())
+	{
+		return;
+	}
+
+	// A shot taken inside a prediction window may predict side effects under that window's key. Those need their own
+	// server window to be confirmed or rolled back, so only shots with nothing predicted are coalesced.
+	const UAbilitySystemComponent* ASC = CurrentActorInfo->AbilitySystemComponent.Get();
+	if (GetFireStreamCoalesceFrames() <= 0 || (ASC && ASC->ScopedPredictionKey.IsValidForMorePrediction()))
+	{
+		// Held shots were fired first
+		FlushFireStream();
+		CallServerSetTargetData(TargetData);
+		return;
+	}
+
+	if (PendingFireStreamShots == 0)
+	{
+		FireStreamStartFrame = GFrameCounter;
+	}
+
+	FGSGameplayAbilityTargetData_ShotTime* ShotTime = new FGSGameplayAbilityTargetData_ShotTime();
+	// Server clock, so the server can compare it against its own world time
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	ShotTime->TimeStamp = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	PendingFireStreamData.Add(ShotTime);
+	PendingFireStreamData.Append(TargetData);
+	PendingFireStreamShots++;
+
+	if (PendingFireStreamShots >= FMath::Max(CVarFireStreamMaxShots.GetValueOnGameThread(), 1))
+	{
+		FlushFireStream();
+	}
+	else if (!bFireStreamTickScheduled)
+	{
+		bFireStreamTickScheduled = true;
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UGSGameplayAbility::TickFireStream);
+	}
+}
+
+void UGSGameplayAbility::FlushFireStream()
+{
+	if (PendingFireStreamShots == 0)
+	{
+		return;
+	}
+
+	FGameplayAbilityTargetDataHandle Payload = MoveTemp(PendingFireStreamData);
+	PendingFireStreamData.Clear();
+
+	INC_DWORD_STAT_BY(STAT_GSFireStreamShots, PendingFireStreamShots);
+	INC_DWORD_STAT(STAT_GSFireStreamPayloads);
+	PendingFireStreamShots = 0;
+
+	// Every shot in the payload shares one prediction window. Fine, since none of them predicted anything.
 	if (IsPredictingClient())
 	{
-		UAbilitySystemComponent* ASC = CurrentActorInfo->AbilitySystemComponent.Get();
-		check(ASC);
+		CallServerSetTargetData(Payload);
+	}
+}
+
+TArray<FGSFireStreamShot> UGSGameplayAbility::SplitFireStreamTargetData(const FGameplayAbilityTargetDataHandle& TargetData)
+{
+	TArray<FGSFireStreamShot> Shots;
+
+	for (const TSharedPtr<FGameplayAbilityTargetData>& Data : TargetData.Data)
+	{
+		if (!Data.IsValid())
+		{
+			continue;
+		}
+
+		if (Data->GetScriptStruct() == FGSGameplayAbilityTargetData_ShotTime::StaticStruct())
+		{
+			Shots.AddDefaulted_GetRef().TimeStamp = static_cast<const FGSGameplayAbilityTargetData_ShotTime*>(Data.Get())->TimeStamp;
+			continue;
+		}
+
+		if (Shots.Num() == 0)
+		{
+			Shots.AddDefaulted();
+		}
+
+		Shots.Last().TargetData.Data.Add(Data);
+	}
+
+	return Shots;
+}
+
+void UGSGameplayAbility::EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled)
+{
+	// Held shots must reach the server before it hears that the ability ended
+	if (IsActive())
+	{
+		FlushFireStream();
+	}
+
+	Super::EndAbility(Handle, ActorInfo, ActivationInfo, bReplicateEndAbility, bWasCancelled);
+}
+
+int32 UGSGameplayAbility::GetFireStreamCoalesceFrames() const
+{
+	return FMath::Min(FireStreamCoalesceFrames, CVarFireStreamMaxCoalesceFrames.GetValueOnGameThread());
+}
 
-		FScopedPredictionWindow	ScopedPrediction(ASC, IsPredictingClient());
+void UGSGameplayAbility::TickFireStream()
+{
+	bFireStreamTickScheduled = false;
 
-		FGameplayTag ApplicationTag; // Fixme: where would this be useful?
-		CurrentActorInfo->AbilitySystemComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle,
-			CurrentActivationInfo.GetActivationPredictionKey(), TargetData, ApplicationTag, ASC->ScopedPredictionKey);
+	if (PendingFireStreamShots == 0)
+	{
+		return;
 	}
+
+	if (!IsActive() || GFrameCounter - FireStreamStartFrame >= (uint64)FMath::Max(GetFireStreamCoalesceFrames(), 0))
+	{
+		FlushFireStream();
+		return;
+	}
+
+	bFireStreamTickScheduled = true;
+	GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UGSGameplayAbility::TickFireStream);
+}
+
+void UGSGameplayAbility::CallServerSetTargetData(const FGameplayAbilityTargetDataHandle& TargetData)
+{
+	UAbilitySystemComponent* ASC = CurrentActorInfo->AbilitySystemComponent.Get();
+	check(ASC);
+
+	FScopedPredictionWindow	ScopedPrediction(ASC, IsPredictingClient());
+
+	FGameplayTag ApplicationTag; // Fixme: where would this be useful?
+	ASC->CallServerSetReplicatedTargetData(CurrentSpecHandle,
+		CurrentActivationInfo.GetActivationPredictionKey(), TargetData, ApplicationTag, ASC->ScopedPredictionKey);
 }
 
 bool UGSGameplayAbility::IsInputPressed() const
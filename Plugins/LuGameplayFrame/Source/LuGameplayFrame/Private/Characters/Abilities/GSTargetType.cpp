@@ -3,25 +3,95 @@
 
 #include "Characters/Abilities/GSTargetType.h"
 #include "Characters/VTCharacterBase.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "LuGameplayFrame.h"
 
-void UGSTargetType::GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+DECLARE_CYCLE_STAT(TEXT("Collect Targets"), STAT_GSCollectTargets, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blueprint Targeting Calls"), STAT_GSBlueprintTargetingCalls, STATGROUP_LuGameplayFrame);
+
+UGSTargetType::UGSTargetType()
+{
+	static FName GetTargetsFuncName = GET_FUNCTION_NAME_CHECKED(UGSTargetType, GetTargets);
+	const UFunction* Func = GetClass()->FindFunctionByName(GetTargetsFuncName);
+	bHasBlueprintGetTargets = Func && ensure(Func->GetOuter()) && Func->GetOuter()->IsA(UBlueprintGeneratedClass::StaticClass());
+}
+
+void UGSTargetType::CollectTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_GSCollectTargets);
+
+	if (!bHasBlueprintGetTargets)
+	{
+		GatherTargets(TargetingCharacter, TargetingActor, EventData, OutTargets);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_GSBlueprintTargetingCalls);
+
+	TArray<FGameplayAbilityTargetDataHandle> TargetData;
+	TArray<FHitResult> HitResults;
+	TArray<AActor*> Actors;
+	GetTargets(TargetingCharacter, TargetingActor, EventData, TargetData, HitResults, Actors);
+
+	OutTargets.TargetData.Append(TargetData);
+	OutTargets.HitResults.Append(HitResults);
+	OutTargets.Actors.Append(Actors);
+}
+
+void UGSTargetType::GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const
 {
 	return;
 }
 
-void UGSTargetType_UseOwner::GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+void UGSTargetType::GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
 {
-	OutActors.Add(TargetingCharacter);
+	// Lets Blueprint subclasses call the parent and still get the native targeting
+	FGSTargetBuffers Targets;
+	GatherTargets(TargetingCharacter, TargetingActor, EventData, Targets);
+
+	OutTargetData.Append(Targets.TargetData);
+	OutHitResults.Append(Targets.HitResults);
+	OutActors.Append(Targets.Actors);
 }
 
-void UGSTargetType_UseEventData::GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const
+void UGSTargetType_UseOwner::GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const
+{
+	OutTargets.Actors.Add(TargetingCharacter);
+}
+
+void UGSTargetType_UseEventData::GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const
 {
 	if (const FHitResult* FoundHitResult = EventData.ContextHandle.GetHitResult())
 	{
-		OutHitResults.Add(*FoundHitResult);
+		OutTargets.HitResults.Add(*FoundHitResult);
 	}
 	else if (EventData.Target)
 	{
-		OutActors.Add(const_cast<AActor*>(EventData.Target.Get()));
+		OutTargets.Actors.Add(const_cast<AActor*>(EventData.Target.Get()));
+	}
+}
+
+void UGSTargetType_UseEventTargetData::GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const
+{
+	for (const TSharedPtr<FGameplayAbilityTargetData>& Data : EventData.TargetData.Data)
+	{
+		if (!Data.IsValid())
+		{
+			continue;
+		}
+
+		if (const FHitResult* HitResult = Data->GetHitResult())
+		{
+			OutTargets.HitResults.Add(*HitResult);
+			continue;
+		}
+
+		for (const TWeakObjectPtr<AActor>& Actor : Data->GetActors())
+		{
+			if (Actor.IsValid())
+			{
+				OutTargets.Actors.Add(Actor.Get());
+			}
+		}
 	}
 }
@@ -0,0 +1,240 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Characters/Abilities/VTAbilitySet.h"
+#include "AttributeSet.h"
+#include "Engine/DataTable.h"
+#include "GameplayEffectAggregator.h"
+#include "LuGameplayFrame.h"
+#include "Characters/Abilities/GSAbilitySystemComponent.h"
+#include "Characters/Abilities/GSAbilitySystemGlobals.h"
+#include "Characters/Abilities/GSGameplayAbility.h"
+#include "Characters/Abilities/VTEffectSpecTemplateSubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Ability Set Give"), STAT_VTAbilitySetGive, STATGROUP_LuGameplayFrame);
+DECLARE_CYCLE_STAT(TEXT("Ability Set Take"), STAT_VTAbilitySetTake, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ability Set Abilities Granted"), STAT_VTAbilitySetAbilitiesGranted, STATGROUP_LuGameplayFrame);
+
+namespace
+{
+	template<typename FunctionType>
+	void ForEachAttribute(const UAttributeSet* AttributeSet, FunctionType&& Function)
+	{
+		for (TFieldIterator<FProperty> It(AttributeSet->GetClass()); It; ++It)
+		{
+			if (FGameplayAttribute::IsGameplayAttributeDataProperty(*It))
+			{
+				Function(FGameplayAttribute(*It));
+			}
+		}
+	}
+}
+
+void FVTAbilitySetGrantedHandles::AddAbilitySpecHandles(const TArray<FGameplayAbilitySpecHandle>& Handles)
+{
+	AbilitySpecHandles.Append(Handles);
+}
+
+void FVTAbilitySetGrantedHandles::AddGameplayEffectHandle(const FActiveGameplayEffectHandle& Handle)
+{
+	if (Handle.IsValid())
+	{
+		GameplayEffectHandles.Add(Handle);
+	}
+}
+
+void FVTAbilitySetGrantedHandles::AddAttributeSet(UAttributeSet* AttributeSet)
+{
+	FVTAbilitySet_GrantedAttributeSet& Granted = GrantedAttributeSets.AddDefaulted_GetRef();
+	Granted.AttributeSet = AttributeSet;
+	ForEachAttribute(AttributeSet, [AttributeSet, &Granted](const FGameplayAttribute& Attribute)
+	{
+		Granted.StartingValues.Add(Attribute.GetGameplayAttributeData(AttributeSet)->GetBaseValue());
+	});
+}
+
+bool FVTAbilitySetGrantedHandles::ReuseKeptAttributeSet(UGSAbilitySystemComponent* ASC, TSubclassOf<UAttributeSet> AttributeSetClass)
+{
+	const int32 Index = KeptAttributeSets.IndexOfByPredicate([AttributeSetClass](const FVTAbilitySet_GrantedAttributeSet& Kept)
+	{
+		return Kept.AttributeSet && Kept.AttributeSet->GetClass() == AttributeSetClass;
+	});
+	if (Index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FVTAbilitySet_GrantedAttributeSet& Kept = KeptAttributeSets[Index];
+
+	// Through the ASC so attribute change delegates fire like they would for a new set
+	int32 ValueIndex = 0;
+	ForEachAttribute(Kept.AttributeSet, [ASC, &Kept, &ValueIndex](const FGameplayAttribute& Attribute)
+	{
+		ASC->SetNumericAttributeBase(Attribute, Kept.StartingValues[ValueIndex++]);
+	});
+
+	GrantedAttributeSets.Add(MoveTemp(Kept));
+	KeptAttributeSets.RemoveAtSwap(Index);
+	return true;
+}
+
+void FVTAbilitySetGrantedHandles::RemoveKeptAttributeSets(UGSAbilitySystemComponent* ASC)
+{
+	if (IsValid(ASC))
+	{
+		for (const FVTAbilitySet_GrantedAttributeSet& Kept : KeptAttributeSets)
+		{
+			if (Kept.AttributeSet)
+			{
+				ASC->RemoveSpawnedAttribute(Kept.AttributeSet);
+			}
+		}
+	}
+
+	KeptAttributeSets.Reset();
+}
+
+void FVTAbilitySetGrantedHandles::TakeFromAbilitySystem(UGSAbilitySystemComponent* ASC, bool bKeepAttributeSets)
+{
+	if (!IsValid(ASC) || !ASC->IsOwnerActorAuthoritative())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VTAbilitySetTake);
+
+	ASC->ClearAbilitiesBatched(AbilitySpecHandles);
+
+	for (const FActiveGameplayEffectHandle& Handle : GameplayEffectHandles)
+	{
+		ASC->RemoveActiveGameplayEffect(Handle);
+	}
+
+	if (bKeepAttributeSets)
+	{
+		KeptAttributeSets.Append(MoveTemp(GrantedAttributeSets));
+	}
+	else
+	{
+		for (const FVTAbilitySet_GrantedAttributeSet& Granted : GrantedAttributeSets)
+		{
+			if (Granted.AttributeSet)
+			{
+				ASC->RemoveSpawnedAttribute(Granted.AttributeSet);
+			}
+		}
+
+		RemoveKeptAttributeSets(ASC);
+	}
+
+	AbilitySpecHandles.Reset();
+	GameplayEffectHandles.Reset();
+	GrantedAttributeSets.Reset();
+}
+
+bool FVTAbilitySetGrantedHandles::IsEmpty() const
+{
+	return AbilitySpecHandles.Num() == 0 && GameplayEffectHandles.Num() == 0 && GrantedAttributeSets.Num() == 0 && KeptAttributeSets.Num() == 0;
+}
+
+void UVTAbilitySet::GiveToAbilitySystem(UGSAbilitySystemComponent* ASC, FVTAbilitySetGrantedHandles* OutGrantedHandles, UObject* SourceObject) const
+{
+	if (!IsValid(ASC) || !ASC->IsOwnerActorAuthoritative())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_VTAbilitySetGive);
+
+	// Attribute sets first so the effects below have something to modify
+	for (const FVTAbilitySet_AttributeSet& SetToGrant : GrantedAttributes)
+	{
+		if (!SetToGrant.AttributeSet)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s() GrantedAttributes has an empty entry in %s"), *FString(__FUNCTION__), *GetName());
+			continue;
+		}
+
+		// A round reset keeps the sets, so they don't have to be created again
+		if (OutGrantedHandles && OutGrantedHandles->ReuseKeptAttributeSet(ASC, SetToGrant.AttributeSet))
+		{
+			continue;
+		}
+
+		UAttributeSet* NewSet = NewObject<UAttributeSet>(ASC->GetOwner(), SetToGrant.AttributeSet);
+		if (SetToGrant.DefaultStartingTable)
+		{
+			NewSet->InitFromMetaDataTable(SetToGrant.DefaultStartingTable);
+		}
+		ASC->AddAttributeSetSubobject(NewSet);
+
+		if (OutGrantedHandles)
+		{
+			OutGrantedHandles->AddAttributeSet(NewSet);
+		}
+	}
+
+	TArray<FGameplayAbilitySpec> Specs;
+	Specs.Reserve(GrantedGameplayAbilities.Num());
+	for (const FVTAbilitySet_GameplayAbility& AbilityToGrant : GrantedGameplayAbilities)
+	{
+		if (!AbilityToGrant.Ability)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s() GrantedGameplayAbilities has an empty entry in %s"), *FString(__FUNCTION__), *GetName());
+			continue;
+		}
+
+		const UGSGameplayAbility* AbilityCDO = AbilityToGrant.Ability.GetDefaultObject();
+		Specs.Emplace(AbilityToGrant.Ability, AbilityToGrant.AbilityLevel, static_cast<int32>(AbilityCDO->AbilityInputID), SourceObject);
+	}
+
+	TArray<FGameplayAbilitySpecHandle> AbilityHandles;
+	ASC->GiveAbilitiesBatched(Specs, AbilityHandles);
+	INC_DWORD_STAT_BY(STAT_VTAbilitySetAbilitiesGranted, AbilityHandles.Num());
+
+	if (OutGrantedHandles)
+	{
+		OutGrantedHandles->AddAbilitySpecHandles(AbilityHandles);
+	}
+
+	if (GrantedGameplayEffects.Num() > 0)
+	{
+		FGameplayEffectContextHandle EffectContext = ASC->MakeEffectContext();
+		EffectContext.AddSourceObject(SourceObject);
+
+		// Attributes touched by several effects are recalculated once for the whole set
+		FScopedAggregatorOnDirtyBatch AggregatorBatch;
+
+		for (const FVTAbilitySet_GameplayEffect& EffectToGrant : GrantedGameplayEffects)
+		{
+			TSharedPtr<const FGameplayEffectSpec> Template = UVTEffectSpecTemplateSubsystem::GetEffectSpecTemplate(EffectToGrant.GameplayEffect, EffectToGrant.EffectLevel);
+			if (!Template.IsValid())
+			{
+				UE_LOG(LogTemp, Error, TEXT("%s() GrantedGameplayEffects has an empty entry in %s"), *FString(__FUNCTION__), *GetName());
+				continue;
+			}
+
+			FGameplayEffectSpec Spec(*Template);
+			Spec.SetContext(EffectContext, true);
+			Spec.CaptureDataFromSource();
+
+			const FActiveGameplayEffectHandle Handle = ASC->ApplyGameplayEffectSpecToSelf(Spec);
+			if (OutGrantedHandles)
+			{
+				OutGrantedHandles->AddGameplayEffectHandle(Handle);
+			}
+		}
+	}
+}
+
+FVTAbilitySetGrantedHandles UVTAbilitySet::K2_GiveToAbilitySystem(UAbilitySystemComponent* ASC, UObject* SourceObject) const
+{
+	FVTAbilitySetGrantedHandles GrantedHandles;
+	GiveToAbilitySystem(Cast<UGSAbilitySystemComponent>(ASC), &GrantedHandles, SourceObject);
+	return GrantedHandles;
+}
+
+void UVTAbilitySet::K2_TakeFromAbilitySystem(UAbilitySystemComponent* ASC, FVTAbilitySetGrantedHandles& GrantedHandles)
+{
+	GrantedHandles.TakeFromAbilitySystem(Cast<UGSAbilitySystemComponent>(ASC));
+}
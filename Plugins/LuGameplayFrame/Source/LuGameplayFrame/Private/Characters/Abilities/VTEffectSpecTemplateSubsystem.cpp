@@ -0,0 +1,94 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Characters/Abilities/VTEffectSpecTemplateSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+void UVTEffectSpecTemplateSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UVTEffectSpecTemplateSubsystem::OnWorldCleanup);
+
+#if WITH_EDITOR
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddUObject(this, &UVTEffectSpecTemplateSubsystem::OnObjectsReplaced);
+	ReinstancingCompleteHandle = FCoreUObjectDelegates::ReloadReinstancingCompleteDelegate.AddUObject(this, &UVTEffectSpecTemplateSubsystem::ClearTemplates);
+#endif
+}
+
+void UVTEffectSpecTemplateSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+	FCoreUObjectDelegates::ReloadReinstancingCompleteDelegate.Remove(ReinstancingCompleteHandle);
+#endif
+
+	ClearTemplates();
+
+	Super::Deinitialize();
+}
+
+void UVTEffectSpecTemplateSubsystem::AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector)
+{
+	Super::AddReferencedObjects(InThis, Collector);
+
+	UVTEffectSpecTemplateSubsystem* This = CastChecked<UVTEffectSpecTemplateSubsystem>(InThis);
+	for (TPair<TPair<FObjectKey, float>, FEffectSpecTemplate>& Template : This->EffectSpecTemplates)
+	{
+		Collector.AddReferencedObject(Template.Value.EffectClass, This);
+	}
+}
+
+TSharedPtr<const FGameplayEffectSpec> UVTEffectSpecTemplateSubsystem::GetEffectSpecTemplate(TSubclassOf<UGameplayEffect> GameplayEffect, float Level)
+{
+	if (!GameplayEffect)
+	{
+		return nullptr;
+	}
+
+	UVTEffectSpecTemplateSubsystem* Subsystem = GEngine ? GEngine->GetEngineSubsystem<UVTEffectSpecTemplateSubsystem>() : nullptr;
+	if (!Subsystem)
+	{
+		return MakeShared<FGameplayEffectSpec>(GameplayEffect->GetDefaultObject<UGameplayEffect>(), FGameplayEffectContextHandle(), Level);
+	}
+
+	const TPair<FObjectKey, float> Key(FObjectKey(GameplayEffect.Get()), Level);
+	if (const FEffectSpecTemplate* Template = Subsystem->EffectSpecTemplates.Find(Key))
+	{
+		return Template->Spec;
+	}
+
+	FEffectSpecTemplate& Template = Subsystem->EffectSpecTemplates.Add(Key);
+	Template.EffectClass = GameplayEffect.Get();
+	Template.Spec = MakeShared<FGameplayEffectSpec>(GameplayEffect->GetDefaultObject<UGameplayEffect>(), FGameplayEffectContextHandle(), Level);
+	return Template.Spec;
+}
+
+void UVTEffectSpecTemplateSubsystem::ClearTemplates()
+{
+	EffectSpecTemplates.Reset();
+}
+
+void UVTEffectSpecTemplateSubsystem::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	// Map changes start from fresh templates, in case the effects were loaded with the old map
+	ClearTemplates();
+}
+
+#if WITH_EDITOR
+void UVTEffectSpecTemplateSubsystem::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	for (auto It = EffectSpecTemplates.CreateIterator(); It; ++It)
+	{
+		UClass* EffectClass = It.Value().EffectClass;
+		if (ReplacementMap.Contains(EffectClass) || ReplacementMap.Contains(EffectClass->GetDefaultObject(false)))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+#endif
@@ -3,9 +3,12 @@
 
 #include "Characters/GSCharacterMovementComponent.h"
 #include "AbilitySystemComponent.h"
+#include "Characters/Abilities/AttributeSets/GSAttributeSetBase.h"
+#include "Characters/Abilities/GSAbilitySystemComponent.h"
 #include "Characters/Abilities/GSAbilitySystemGlobals.h"
 #include "Characters/VTCharacterBase.h"
 #include "GameplayTagContainer.h"
+#include "VTGameplayTags.h"
 
 UGSCharacterMovementComponent::UGSCharacterMovementComponent()
 {
@@ -13,9 +16,23 @@ UGSCharacterMovementComponent::UGSCharacterMovementComponent()
 	ADSSpeedMultiplier = 0.8f;
 	KnockedDownSpeedMultiplier = 0.4f;
 
-	KnockedDownTag = FGameplayTag::RequestGameplayTag("State.KnockedDown");
-	InteractingTag = FGameplayTag::RequestGameplayTag("State.Interacting");
-	InteractingRemovalTag = FGameplayTag::RequestGameplayTag("State.InteractingRemoval");
+	SprintStaminaCostPerSecond = 20.0f;
+	SprintStaminaRecoverThreshold = 20.0f;
+	SprintStaminaErrorTolerance = 1.0f;
+	StaminaReconcileInterval = 1.0f;
+
+	bSprintExhausted = false;
+	SprintStamina = -1.0f;
+	TimeSinceStaminaReconcile = 0.0f;
+	LastReconciledStamina = -1.0f;
+	LastAbilityInputMaskTimeStamp = -1.0f;
+
+	SetNetworkMoveDataContainer(GSNetworkMoveDataContainer);
+	SetMoveResponseDataContainer(GSMoveResponseDataContainer);
+
+	KnockedDownTag = VTGameplayTags::State_KnockedDown;
+	InteractingTag = VTGameplayTags::State_Interacting;
+	InteractingRemovalTag = VTGameplayTags::State_InteractingRemoval;
 }
 
 float UGSCharacterMovementComponent::GetMaxSpeed() const
@@ -44,7 +61,7 @@ float UGSCharacterMovementComponent::GetMaxSpeed() const
 		return Owner->GetMoveSpeed() * KnockedDownSpeedMultiplier;
 	}
 
-	if (RequestToStartSprinting)
+	if (IsSprinting())
 	{
 		return Owner->GetMoveSpeed() * SprintSpeedMultiplier;
 	}
@@ -85,6 +102,75 @@ FNetworkPredictionData_Client* UGSCharacterMovementComponent::GetPredictionData_
 	return ClientPredictionData;
 }
 
+void UGSCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	// Simulated proxies don't predict stamina, they only see the replicated attribute
+	if (!CharacterOwner || CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		return;
+	}
+
+	TickSprintStamina(DeltaSeconds);
+
+	if (CharacterOwner->GetLocalRole() == ROLE_Authority)
+	{
+		ReconcileStaminaAttribute(DeltaSeconds);
+	}
+}
+
+void UGSCharacterMovementComponent::ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData)
+{
+	Super::ServerMove_PerformMovement(MoveData);
+
+	// Only moves the server accepted carry input, and resent old moves are skipped
+	const FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+	if (!ServerData || ServerData->CurrentClientTimeStamp != MoveData.TimeStamp || MoveData.TimeStamp == LastAbilityInputMaskTimeStamp)
+	{
+		return;
+	}
+
+	LastAbilityInputMaskTimeStamp = MoveData.TimeStamp;
+
+	AVTCharacterBase* Owner = Cast<AVTCharacterBase>(GetOwner());
+	UGSAbilitySystemComponent* ASC = Owner ? Cast<UGSAbilitySystemComponent>(Owner->GetAbilitySystemComponent()) : nullptr;
+	if (ASC)
+	{
+		const FGSCharacterNetworkMoveData& GSMoveData = static_cast<const FGSCharacterNetworkMoveData&>(MoveData);
+		ASC->ServerApplyAbilityInputEdges(GSMoveData.AbilityInputPressedEdges, GSMoveData.AbilityInputReleasedEdges, GSMoveData.AbilityInputMask);
+	}
+}
+
+bool UGSCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	if (Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode))
+	{
+		return true;
+	}
+
+	const FGSCharacterNetworkMoveData* MoveData = static_cast<const FGSCharacterNetworkMoveData*>(GetCurrentNetworkMoveData());
+	if (MoveData && SprintStamina >= 0.0f)
+	{
+		return FMath::Abs(MoveData->SprintStamina - SprintStamina) > SprintStaminaErrorTolerance;
+	}
+
+	return false;
+}
+
+void UGSCharacterMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	if (MoveResponse.IsCorrection())
+	{
+		// Take the server's stamina before the saved moves are replayed on top of the corrected position
+		const FGSCharacterMoveResponseDataContainer& GSMoveResponse = static_cast<const FGSCharacterMoveResponseDataContainer&>(MoveResponse);
+		SprintStamina = GSMoveResponse.SprintStamina;
+		bSprintExhausted = GSMoveResponse.bSprintExhausted;
+	}
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+
 void UGSCharacterMovementComponent::StartSprinting()
 {
 	RequestToStartSprinting = true;
@@ -95,6 +181,104 @@ void UGSCharacterMovementComponent::StopSprinting()
 	RequestToStartSprinting = false;
 }
 
+bool UGSCharacterMovementComponent::IsSprinting() const
+{
+	return RequestToStartSprinting && !bSprintExhausted;
+}
+
+float UGSCharacterMovementComponent::GetPredictedStamina() const
+{
+	if (SprintStamina < 0.0f)
+	{
+		AVTCharacterBase* Owner = Cast<AVTCharacterBase>(GetOwner());
+		return Owner ? Owner->GetStamina() : 0.0f;
+	}
+
+	return SprintStamina;
+}
+
+void UGSCharacterMovementComponent::TickSprintStamina(float DeltaSeconds)
+{
+	AVTCharacterBase* Owner = Cast<AVTCharacterBase>(GetOwner());
+	UAbilitySystemComponent* ASC = Owner ? Owner->GetAbilitySystemComponent() : nullptr;
+	if (!ASC)
+	{
+		return;
+	}
+
+	const float MaxStamina = Owner->GetMaxStamina();
+	if (MaxStamina <= 0.0f)
+	{
+		// Attributes haven't been initialized yet
+		return;
+	}
+
+	if (SprintStamina < 0.0f)
+	{
+		SprintStamina = Owner->GetStamina();
+		LastReconciledStamina = SprintStamina;
+	}
+
+	// Only drain while actually moving. Holding sprint while standing still regenerates like walking.
+	const bool bDraining = IsSprinting() && !Velocity.IsNearlyZero() && IsMovingOnGround();
+	if (bDraining)
+	{
+		SprintStamina = FMath::Max(SprintStamina - SprintStaminaCostPerSecond * DeltaSeconds, 0.0f);
+		if (SprintStamina <= 0.0f)
+		{
+			bSprintExhausted = true;
+		}
+	}
+	else
+	{
+		const float StaminaRegenRate = ASC->GetNumericAttribute(UGSAttributeSetBase::GetStaminaRegenRateAttribute());
+		SprintStamina = FMath::Min(SprintStamina + StaminaRegenRate * DeltaSeconds, MaxStamina);
+		if (bSprintExhausted && SprintStamina >= FMath::Min(SprintStaminaRecoverThreshold, MaxStamina))
+		{
+			bSprintExhausted = false;
+		}
+	}
+}
+
+void UGSCharacterMovementComponent::ReconcileStaminaAttribute(float DeltaSeconds)
+{
+	if (SprintStamina < 0.0f)
+	{
+		return;
+	}
+
+	TimeSinceStaminaReconcile += DeltaSeconds;
+	if (TimeSinceStaminaReconcile < StaminaReconcileInterval)
+	{
+		return;
+	}
+	TimeSinceStaminaReconcile = 0.0f;
+
+	AVTCharacterBase* Owner = Cast<AVTCharacterBase>(GetOwner());
+	UAbilitySystemComponent* ASC = Owner ? Owner->GetAbilitySystemComponent() : nullptr;
+	if (!ASC)
+	{
+		return;
+	}
+
+	// Something other than sprinting changed Stamina since the last write (i.e. a GE). Add that change on top of what we
+	// simulated instead of adopting the attribute, which would throw away the sprint drain since the last write.
+	// The client gets it through a correction.
+	const float AttributeStamina = Owner->GetStamina();
+	const float ExternalDelta = AttributeStamina - LastReconciledStamina;
+	if (!FMath::IsNearlyZero(ExternalDelta, SprintStaminaErrorTolerance))
+	{
+		SprintStamina = FMath::Clamp(SprintStamina + ExternalDelta, 0.0f, Owner->GetMaxStamina());
+	}
+
+	if (!FMath::IsNearlyEqual(AttributeStamina, SprintStamina, SprintStaminaErrorTolerance))
+	{
+		ASC->ApplyModToAttribute(UGSAttributeSetBase::GetStaminaAttribute(), EGameplayModOp::Additive, SprintStamina - AttributeStamina);
+	}
+
+	LastReconciledStamina = Owner->GetStamina();
+}
+
 void UGSCharacterMovementComponent::StartAimDownSights()
 {
 	RequestToStartADS = true;
@@ -111,6 +295,12 @@ void UGSCharacterMovementComponent::FGSSavedMove::Clear()
 
 	SavedRequestToStartSprinting = false;
 	SavedRequestToStartADS = false;
+	SavedSprintExhausted = false;
+	SavedAbilityInputMask = 0;
+	SavedAbilityInputPressedEdges = 0;
+	SavedAbilityInputReleasedEdges = 0;
+	SavedStartSprintStamina = -1.0f;
+	SavedEndSprintStamina = -1.0f;
 }
 
 uint8 UGSCharacterMovementComponent::FGSSavedMove::GetCompressedFlags() const
@@ -143,6 +333,18 @@ bool UGSCharacterMovementComponent::FGSSavedMove::CanCombineWith(const FSavedMov
 		return false;
 	}
 
+	// Edges belong to the move they happened in
+	if (HasAbilityInputEdges() || ((FGSSavedMove*)NewMove.Get())->HasAbilityInputEdges())
+	{
+		return false;
+	}
+
+	// Running out of stamina changes the max speed mid move
+	if (SavedSprintExhausted != ((FGSSavedMove*)NewMove.Get())->SavedSprintExhausted)
+	{
+		return false;
+	}
+
 	return Super::CanCombineWith(NewMove, Character, MaxDelta);
 }
 
@@ -155,7 +357,27 @@ void UGSCharacterMovementComponent::FGSSavedMove::SetMoveFor(ACharacter* Charact
 	{
 		SavedRequestToStartSprinting = CharacterMovement->RequestToStartSprinting;
 		SavedRequestToStartADS = CharacterMovement->RequestToStartADS;
+		SavedSprintExhausted = CharacterMovement->bSprintExhausted;
+		SavedStartSprintStamina = CharacterMovement->SprintStamina;
+	}
+
+	const AVTCharacterBase* Owner = Cast<AVTCharacterBase>(Character);
+	UGSAbilitySystemComponent* ASC = Owner ? Cast<UGSAbilitySystemComponent>(Owner->GetAbilitySystemComponent()) : nullptr;
+	if (ASC)
+	{
+		SavedAbilityInputMask = ASC->GetLocalAbilityInputMask();
+		ASC->ConsumeLocalAbilityInputEdges(SavedAbilityInputPressedEdges, SavedAbilityInputReleasedEdges);
+	}
+}
+
+bool UGSCharacterMovementComponent::FGSSavedMove::IsImportantMove(const FSavedMovePtr& LastAckedMove) const
+{
+	if (HasAbilityInputEdges())
+	{
+		return true;
 	}
+
+	return Super::IsImportantMove(LastAckedMove);
 }
 
 void UGSCharacterMovementComponent::FGSSavedMove::PrepMoveFor(ACharacter* Character)
@@ -168,6 +390,121 @@ void UGSCharacterMovementComponent::FGSSavedMove::PrepMoveFor(ACharacter* Charac
 	}
 }
 
+void UGSCharacterMovementComponent::FGSSavedMove::CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation)
+{
+	Super::CombineWith(OldMove, InCharacter, PC, OldStartLocation);
+
+	// The pending move is resimulated as part of this one, so rewind stamina to where it started
+	UGSCharacterMovementComponent* CharacterMovement = Cast<UGSCharacterMovementComponent>(InCharacter->GetCharacterMovement());
+	const FGSSavedMove* OldGSMove = static_cast<const FGSSavedMove*>(OldMove);
+	if (CharacterMovement && OldGSMove->SavedStartSprintStamina >= 0.0f)
+	{
+		CharacterMovement->SprintStamina = OldGSMove->SavedStartSprintStamina;
+		CharacterMovement->bSprintExhausted = OldGSMove->SavedSprintExhausted;
+	}
+}
+
+void UGSCharacterMovementComponent::FGSSavedMove::PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode)
+{
+	Super::PostUpdate(Character, PostUpdateMode);
+
+	UGSCharacterMovementComponent* CharacterMovement = Cast<UGSCharacterMovementComponent>(Character->GetCharacterMovement());
+	if (CharacterMovement)
+	{
+		SavedEndSprintStamina = CharacterMovement->SprintStamina;
+	}
+}
+
+void UGSCharacterMovementComponent::FGSCharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	SprintStamina = static_cast<const FGSSavedMove&>(ClientMove).SavedEndSprintStamina;
+	const FGSSavedMove& GSClientMove = static_cast<const FGSSavedMove&>(ClientMove);
+	AbilityInputMask = GSClientMove.SavedAbilityInputMask;
+	AbilityInputPressedEdges = GSClientMove.SavedAbilityInputPressedEdges;
+	AbilityInputReleasedEdges = GSClientMove.SavedAbilityInputReleasedEdges;
+}
+
+bool UGSCharacterMovementComponent::FGSCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// Tenths of a point, well inside SprintStaminaErrorTolerance. Zero means the client isn't simulating stamina.
+	uint32 QuantizedStamina = SprintStamina >= 0.0f ? uint32(FMath::RoundToInt(SprintStamina * 10.0f)) + 1 : 0;
+	Ar.SerializeIntPacked(QuantizedStamina);
+	if (Ar.IsLoading())
+	{
+		SprintStamina = QuantizedStamina > 0 ? float(QuantizedStamina - 1) / 10.0f : -1.0f;
+	}
+
+	// Most moves have no ability input edges, and the held mask only matters for inputs that have one
+	const uint16 EdgeBits = AbilityInputPressedEdges | AbilityInputReleasedEdges;
+	bool bHasAbilityInput = EdgeBits != 0;
+	Ar.SerializeBits(&bHasAbilityInput, 1);
+	if (!bHasAbilityInput)
+	{
+		AbilityInputMask = 0;
+		AbilityInputPressedEdges = 0;
+		AbilityInputReleasedEdges = 0;
+		return !Ar.IsError();
+	}
+
+	// Only as many bits as the highest InputID with an edge
+	uint32 NumBitsMinusOne = Ar.IsSaving() ? FMath::FloorLog2(EdgeBits) : 0;
+	Ar.SerializeInt(NumBitsMinusOne, 16);
+	const int32 NumBits = int32(NumBitsMinusOne) + 1;
+
+	if (Ar.IsLoading())
+	{
+		AbilityInputMask = 0;
+		AbilityInputPressedEdges = 0;
+		AbilityInputReleasedEdges = 0;
+	}
+	else
+	{
+		AbilityInputMask &= uint16((1u << NumBits) - 1);
+	}
+
+	Ar.SerializeBits(&AbilityInputPressedEdges, NumBits);
+	Ar.SerializeBits(&AbilityInputReleasedEdges, NumBits);
+	Ar.SerializeBits(&AbilityInputMask, NumBits);
+
+	return !Ar.IsError();
+}
+
+UGSCharacterMovementComponent::FGSCharacterNetworkMoveDataContainer::FGSCharacterNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
+
+void UGSCharacterMovementComponent::FGSCharacterMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	const UGSCharacterMovementComponent& GSCharacterMovement = static_cast<const UGSCharacterMovementComponent&>(CharacterMovement);
+	SprintStamina = GSCharacterMovement.SprintStamina;
+	bSprintExhausted = GSCharacterMovement.bSprintExhausted;
+}
+
+bool UGSCharacterMovementComponent::FGSCharacterMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+	{
+		return false;
+	}
+
+	if (IsCorrection())
+	{
+		Ar << SprintStamina;
+		Ar.SerializeBits(&bSprintExhausted, 1);
+	}
+
+	return !Ar.IsError();
+}
+
 UGSCharacterMovementComponent::FGSNetworkPredictionData_Client::FGSNetworkPredictionData_Client(const UCharacterMovementComponent& ClientMovement)
 	: Super(ClientMovement)
 {
@@ -3,15 +3,24 @@
 
 #include "Characters/VTCharacterBase.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameplayEffectAggregator.h"
 #include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
 #include "Sound/SoundCue.h"
 
+#include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
 #include "Characters/Abilities/AttributeSets/GSAttributeSetBase.h"
 #include "Characters/Abilities/GSAbilitySystemComponent.h"
 #include "Characters/Abilities/GSAbilitySystemGlobals.h"
 #include "Characters/Abilities/GSGameplayAbility.h"
+#include "Characters/Abilities/VTEffectSpecTemplateSubsystem.h"
 #include "Characters/GSCharacterMovementComponent.h"
+#include "Characters/VTCharacterPoolSubsystem.h"
+#include "UI/VTAttributeViewModel.h"
+#include "UI/VTDamageNumberPoolSubsystem.h"
 #include "UI/VTDamageTextWidgetComponent.h"
+#include "VTGameplayTags.h"
 
 // Sets default values
 AVTCharacterBase::AVTCharacterBase(const class FObjectInitializer& ObjectInitializer) :
@@ -22,18 +31,25 @@ AVTCharacterBase::AVTCharacterBase(const class FObjectInitializer& ObjectInitial
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Overlap);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Camera, ECollisionResponse::ECR_Ignore);
 
-	bAlwaysRelevant = true;
+	// Relevancy is decided by UVTReplicationGraph (spatial grid + teammates), not by replicating everyone to everyone
+	bAlwaysRelevant = false;
+
+	SignificanceTier = EVTSignificanceTier::High;
+	FloatingStatusBarUpdateInterval = 0.0f;
+	LastCombatTime = -BIG_NUMBER;
+	bIsPooled = false;
+	DefaultNetworkSmoothingMode = ENetworkSmoothingMode::Exponential;
+
+	DamageNumberQueue.SetNum(DamageNumberQueueCapacity);
+	DamageNumberQueueHead = 0;
+	DamageNumberQueueNum = 0;
 
 	// Cache tags
-	DeadTag = FGameplayTag::RequestGameplayTag("State.Dead");
-	EffectRemoveOnDeathTag = FGameplayTag::RequestGameplayTag("Effect.RemoveOnDeath");
+	DeadTag = VTGameplayTags::State_Dead;
+	EffectRemoveOnDeathTag = VTGameplayTags::Effect_RemoveOnDeath;
 
-	// Hardcoding to avoid having to manually set for every Blueprint child class
-	DamageNumberClass = StaticLoadClass(UObject::StaticClass(), nullptr, TEXT("/Game/GASShooter/UI/WC_DamageText.WC_DamageText_C"));
-	if (!DamageNumberClass)
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s() Failed to find DamageNumberClass. If it was moved, please update the reference location in C++."), *FString(__FUNCTION__));
-	}
+	// Hardcoding to avoid having to manually set for every Blueprint child class. Only a path, nothing is loaded here.
+	DamageNumberClass = TSoftClassPtr<UVTDamageTextWidgetComponent>(FSoftObjectPath(TEXT("/Game/GASShooter/UI/WC_DamageText.WC_DamageText_C")));
 }
 
 UAbilitySystemComponent* AVTCharacterBase::GetAbilitySystemComponent() const
@@ -41,6 +57,55 @@ UAbilitySystemComponent* AVTCharacterBase::GetAbilitySystemComponent() const
 	return AbilitySystemComponent;
 }
 
+void AVTCharacterBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AVTCharacterBase, TeamId);
+	DOREPLIFETIME(AVTCharacterBase, AbilityMontageInfoForMeshes);
+}
+
+void AVTCharacterBase::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// Pick up whatever the ASC changed this frame, the property only goes to connections this character is relevant to
+	UGSAbilitySystemComponent* GSASC = Cast<UGSAbilitySystemComponent>(GetAbilitySystemComponent());
+	if (GSASC && GSASC->ReplicatesMontagesThroughAvatar())
+	{
+		AbilityMontageInfoForMeshes = GSASC->GetRepAnimMontageInfoForMeshes();
+	}
+}
+
+void AVTCharacterBase::OnRep_AbilityMontageInfoForMeshes()
+{
+	if (UGSAbilitySystemComponent* GSASC = Cast<UGSAbilitySystemComponent>(GetAbilitySystemComponent()))
+	{
+		GSASC->SetRepAnimMontageInfoFromAvatar(AbilityMontageInfoForMeshes);
+	}
+}
+
+void AVTCharacterBase::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	// Controllers that know their team (i.e. AI) hand it to the pawn they possess
+	const FGenericTeamId ControllerTeam = FGenericTeamId::GetTeamIdentifier(NewController);
+	if (ControllerTeam != FGenericTeamId::NoTeam)
+	{
+		SetGenericTeamId(ControllerTeam);
+	}
+}
+
+void AVTCharacterBase::SetGenericTeamId(const FGenericTeamId& NewTeamId)
+{
+	if (HasAuthority() && TeamId != NewTeamId)
+	{
+		TeamId = NewTeamId;
+		ForceNetUpdate();
+	}
+}
+
 bool AVTCharacterBase::IsAlive() const
 {
 	return GetHealth() > 0.0f;
@@ -51,28 +116,14 @@ int32 AVTCharacterBase::GetAbilityLevel(EGSAbilityInputID AbilityID) const
 	return 1;
 }
 
-void AVTCharacterBase::RemoveCharacterAbilities()
+void AVTCharacterBase::RemoveCharacterAbilities(bool bKeepAttributeSets)
 {
 	if (GetLocalRole() != ROLE_Authority || !IsValid(AbilitySystemComponent) || !AbilitySystemComponent->bCharacterAbilitiesGiven)
 	{
 		return;
 	}
 
-	// Remove any abilities added from a previous call. This checks to make sure the ability is in the startup 'CharacterAbilities' array.
-	TArray<FGameplayAbilitySpecHandle> AbilitiesToRemove;
-	for (const FGameplayAbilitySpec& Spec : AbilitySystemComponent->GetActivatableAbilities())
-	{
-		if ((Spec.SourceObject == this) && CharacterAbilities.Contains(Spec.Ability->GetClass()))
-		{
-			AbilitiesToRemove.Add(Spec.Handle);
-		}
-	}
-
-	// Do in two passes so the removal happens after we have the full list
-	for (int32 i = 0; i < AbilitiesToRemove.Num(); i++)
-	{
-		AbilitySystemComponent->ClearAbility(AbilitiesToRemove[i]);
-	}
+	CharacterAbilityHandles.TakeFromAbilitySystem(AbilitySystemComponent, bKeepAttributeSets);
 
 	AbilitySystemComponent->bCharacterAbilitiesGiven = false;
 }
@@ -100,10 +151,12 @@ void AVTCharacterBase::Die()
 	}
 
 	//TODO replace with a locally executed GameplayCue
+#if !UE_SERVER
 	if (DeathSound)
 	{
 		UGameplayStatics::PlaySoundAtLocation(this, DeathSound, GetActorLocation());
 	}
+#endif
 
 	if (DeathMontage)
 	{
@@ -117,17 +170,214 @@ void AVTCharacterBase::Die()
 
 void AVTCharacterBase::FinishDying()
 {
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		UVTCharacterPoolSubsystem* CharacterPool = GetWorld()->GetSubsystem<UVTCharacterPoolSubsystem>();
+		if (CharacterPool && CharacterPool->ReleaseCharacter(this))
+		{
+			return;
+		}
+	}
+
 	Destroy();
 }
 
+void AVTCharacterBase::DeactivateForPool()
+{
+	bIsPooled = true;
+
+	// Same as being destroyed as far as the controller is concerned, so respawn logic runs as before
+	DetachFromControllerPendingDestroy();
+
+	// The ASC and attributes live on the PlayerState for players. Don't hold on to them, the next owner brings their own.
+	if (IsValid(AbilitySystemComponent) && AbilitySystemComponent->GetOwnerActor() != this)
+	{
+		AbilitySystemComponent = nullptr;
+		AttributeSetBase = nullptr;
+	}
+
+	GetWorldTimerManager().ClearTimer(DamageNumberTimer);
+	DamageNumberQueueHead = 0;
+	DamageNumberQueueNum = 0;
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+	GetMesh()->bPauseAnims = true;
+
+	// Sends the hidden state once, then nothing until reused
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AVTCharacterBase::ReactivateFromPool(const FTransform& SpawnTransform)
+{
+	SetNetDormancy(DORM_Awake);
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetMesh()->bPauseAnims = false;
+
+	RestoreSpawnState();
+
+	bIsPooled = false;
+	ForceNetUpdate();
+}
+
+void AVTCharacterBase::ResetForRound()
+{
+	if (GetLocalRole() != ROLE_Authority || bIsPooled)
+	{
+		return;
+	}
+
+	RestoreSpawnState();
+
+	if (IsValid(AbilitySystemComponent))
+	{
+		if (UGSAmmoAttributeSet* AmmoAttributeSet = const_cast<UGSAmmoAttributeSet*>(AbilitySystemComponent->GetSet<UGSAmmoAttributeSet>()))
+		{
+			AmmoAttributeSet->RefillReserveAmmo();
+		}
+	}
+
+	ForceNetUpdate();
+}
+
+void AVTCharacterBase::RestoreSpawnState()
+{
+	// Undo Die()
+	const AVTCharacterBase* Defaults = GetClass()->GetDefaultObject<AVTCharacterBase>();
+	GetCapsuleComponent()->SetCollisionEnabled(Defaults->GetCapsuleComponent()->GetCollisionEnabled());
+	GetCharacterMovement()->GravityScale = Defaults->GetCharacterMovement()->GravityScale;
+	GetCharacterMovement()->Velocity = FVector::ZeroVector;
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	LastCombatTime = -BIG_NUMBER;
+	LastDamageText.Reset();
+
+	// Characters that own their ASC start over here. Players that were pooled get theirs back from the PlayerState on possession.
+	if (IsValid(AbilitySystemComponent))
+	{
+		// Regrant everything, including ability set effects that ResetForReuse would otherwise strip from a living character.
+		// Ability set attribute sets stay and are reused with their starting values.
+		RemoveCharacterAbilities(true);
+		AbilitySystemComponent->ResetForReuse();
+		AddCharacterAbilities();
+		ApplySpawnEffects();
+	}
+}
+
 void AVTCharacterBase::AddDamageNumber(float Damage, FGameplayTagContainer DamageNumberTags)
 {
-	DamageNumberQueue.Add(FVTDamageNumber(Damage, DamageNumberTags));
+	NotifyCombatActivity();
+
+	// Dedicated servers never show damage numbers
+#if !UE_SERVER
+	const float MergeWindow = UVTDamageNumberPoolSubsystem::GetMergeWindow();
+	if (MergeWindow > 0.0f && LastDamageText.IsValid() && LastDamageText->TryMergeDamage(this, Damage, DamageNumberTags, MergeWindow))
+	{
+		return;
+	}
+
+	if (DamageNumberQueueNum > 0)
+	{
+		// Same kind of hit as the one still waiting, or no room left. Add it to the newest waiting number.
+		FVTDamageNumber& Newest = DamageNumberQueue[(DamageNumberQueueHead + DamageNumberQueueNum - 1) % DamageNumberQueueCapacity];
+		if ((MergeWindow > 0.0f && Newest.Tags == DamageNumberTags) || DamageNumberQueueNum == DamageNumberQueueCapacity)
+		{
+			Newest.DamageAmount += Damage;
+			Newest.Tags.AppendTags(DamageNumberTags);
+			return;
+		}
+	}
+
+	FVTDamageNumber& Slot = DamageNumberQueue[(DamageNumberQueueHead + DamageNumberQueueNum) % DamageNumberQueueCapacity];
+	Slot.DamageAmount = Damage;
+	Slot.Tags = MoveTemp(DamageNumberTags);
+	++DamageNumberQueueNum;
 
 	if (!GetWorldTimerManager().IsTimerActive(DamageNumberTimer))
 	{
 		GetWorldTimerManager().SetTimer(DamageNumberTimer, this, &AVTCharacterBase::ShowDamageNumber, 0.1, true, 0.0f);
 	}
+#endif
+}
+
+void AVTCharacterBase::SetSignificanceTier(EVTSignificanceTier NewTier)
+{
+	SignificanceTier = NewTier;
+
+	// Indexed by EVTSignificanceTier
+	static const float AnimTickIntervals[] = { 0.0f, 1.0f / 30.0f, 1.0f / 10.0f, 0.5f };
+	static const float StatusBarUpdateIntervals[] = { 0.0f, 0.1f, 0.5f, -1.0f };
+
+	const int32 TierIndex = static_cast<int32>(NewTier);
+	FloatingStatusBarUpdateInterval = StatusBarUpdateIntervals[TierIndex];
+
+	// Only throttle what we simulate locally. Authority meshes may be used for hit detection.
+	if (GetLocalRole() != ROLE_SimulatedProxy)
+	{
+		return;
+	}
+
+	if (USkeletalMeshComponent* CharacterMesh = GetMesh())
+	{
+		CharacterMesh->SetComponentTickInterval(AnimTickIntervals[TierIndex]);
+		CharacterMesh->VisibilityBasedAnimTickOption = NewTier == EVTSignificanceTier::Off
+			? EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered
+			: EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+
+	if (UCharacterMovementComponent* Movement = GetCharacterMovement())
+	{
+		switch (NewTier)
+		{
+		case EVTSignificanceTier::High:
+			Movement->NetworkSmoothingMode = DefaultNetworkSmoothingMode;
+			break;
+		case EVTSignificanceTier::Medium:
+			Movement->NetworkSmoothingMode = DefaultNetworkSmoothingMode == ENetworkSmoothingMode::Disabled ? ENetworkSmoothingMode::Disabled : ENetworkSmoothingMode::Linear;
+			break;
+		default:
+			Movement->NetworkSmoothingMode = ENetworkSmoothingMode::Disabled;
+			break;
+		}
+	}
+}
+
+void AVTCharacterBase::NotifyCombatActivity()
+{
+	if (UWorld* World = GetWorld())
+	{
+		LastCombatTime = World->GetTimeSeconds();
+	}
+}
+
+UVTAttributeViewModel* AVTCharacterBase::GetAttributeViewModel()
+{
+	if (!IsValid(AbilitySystemComponent))
+	{
+		return nullptr;
+	}
+
+	if (!AttributeViewModel)
+	{
+		AttributeViewModel = NewObject<UVTAttributeViewModel>(this);
+	}
+
+	// The ASC lives on the PlayerState for players, so it can change on possession
+	if (AttributeViewModel->GetAbilitySystemComponent() != AbilitySystemComponent)
+	{
+		AttributeViewModel->Initialize(AbilitySystemComponent);
+	}
+
+	return AttributeViewModel;
 }
 
 int32 AVTCharacterBase::GetCharacterLevel() const
@@ -240,6 +490,39 @@ float AVTCharacterBase::GetMoveSpeedBaseValue() const
 void AVTCharacterBase::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (GetCharacterMovement())
+	{
+		DefaultNetworkSmoothingMode = GetCharacterMovement()->NetworkSmoothingMode;
+	}
+
+	if (UVTSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UVTSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->RegisterCharacter(this);
+	}
+
+	// Only exists on clients
+#if !UE_SERVER
+	if (UVTDamageNumberPoolSubsystem* DamageNumberPool = GetWorld()->GetSubsystem<UVTDamageNumberPoolSubsystem>())
+	{
+		DamageNumberPool->PreloadDamageNumberClass(DamageNumberClass);
+	}
+#endif
+}
+
+void AVTCharacterBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UVTSignificanceSubsystem* SignificanceSubsystem = GetWorld()->GetSubsystem<UVTSignificanceSubsystem>())
+	{
+		SignificanceSubsystem->UnregisterCharacter(this);
+	}
+
+	if (AttributeViewModel)
+	{
+		AttributeViewModel->Deinitialize();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AVTCharacterBase::AddCharacterAbilities()
@@ -250,12 +533,28 @@ void AVTCharacterBase::AddCharacterAbilities()
 		return;
 	}
 
+	TArray<FGameplayAbilitySpec> Specs;
+	Specs.Reserve(CharacterAbilities.Num());
 	for (TSubclassOf<UGSGameplayAbility>& StartupAbility : CharacterAbilities)
 	{
-		AbilitySystemComponent->GiveAbility(
-			FGameplayAbilitySpec(StartupAbility, GetAbilityLevel(StartupAbility.GetDefaultObject()->AbilityID), static_cast<int32>(StartupAbility.GetDefaultObject()->AbilityInputID), this));
+		Specs.Emplace(StartupAbility, GetAbilityLevel(StartupAbility.GetDefaultObject()->AbilityID), static_cast<int32>(StartupAbility.GetDefaultObject()->AbilityInputID), this);
 	}
 
+	TArray<FGameplayAbilitySpecHandle> AbilityHandles;
+	AbilitySystemComponent->GiveAbilitiesBatched(Specs, AbilityHandles);
+	CharacterAbilityHandles.AddAbilitySpecHandles(AbilityHandles);
+
+	for (const UVTAbilitySet* AbilitySet : AbilitySets)
+	{
+		if (AbilitySet)
+		{
+			AbilitySet->GiveToAbilitySystem(AbilitySystemComponent, &CharacterAbilityHandles, this);
+		}
+	}
+
+	// Sets kept by a round reset that no ability set asked for again
+	CharacterAbilityHandles.RemoveKeptAttributeSets(AbilitySystemComponent);
+
 	AbilitySystemComponent->bCharacterAbilitiesGiven = true;
 }
 
@@ -276,11 +575,7 @@ void AVTCharacterBase::InitializeAttributes()
 	FGameplayEffectContextHandle EffectContext = AbilitySystemComponent->MakeEffectContext();
 	EffectContext.AddSourceObject(this);
 
-	FGameplayEffectSpecHandle NewHandle = AbilitySystemComponent->MakeOutgoingSpec(DefaultAttributes, GetCharacterLevel(), EffectContext);
-	if (NewHandle.IsValid())
-	{
-		FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(*NewHandle.Data.Get());
-	}
+	ApplyEffectFromTemplate(DefaultAttributes, EffectContext);
 }
 
 void AVTCharacterBase::AddStartupEffects()
@@ -295,32 +590,69 @@ void AVTCharacterBase::AddStartupEffects()
 
 	for (TSubclassOf<UGameplayEffect> GameplayEffect : StartupEffects)
 	{
-		FGameplayEffectSpecHandle NewHandle = AbilitySystemComponent->MakeOutgoingSpec(GameplayEffect, GetCharacterLevel(), EffectContext);
-		if (NewHandle.IsValid())
-		{
-			FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToTarget(*NewHandle.Data.Get(), AbilitySystemComponent);
-		}
+		ApplyEffectFromTemplate(GameplayEffect, EffectContext);
 	}
 
 	AbilitySystemComponent->bStartupEffectsApplied = true;
 }
 
+void AVTCharacterBase::ApplySpawnEffects()
+{
+	if (!IsValid(AbilitySystemComponent))
+	{
+		return;
+	}
+
+	{
+		// Attributes touched by several effects are recalculated once instead of once per effect
+		FScopedAggregatorOnDirtyBatch AggregatorBatch;
+
+		InitializeAttributes();
+		AddStartupEffects();
+	}
+
+	ForceNetUpdate();
+}
+
+FActiveGameplayEffectHandle AVTCharacterBase::ApplyEffectFromTemplate(TSubclassOf<UGameplayEffect> GameplayEffect, const FGameplayEffectContextHandle& EffectContext)
+{
+	TSharedPtr<const FGameplayEffectSpec> Template = UVTEffectSpecTemplateSubsystem::GetEffectSpecTemplate(GameplayEffect, GetCharacterLevel());
+	if (!Template.IsValid() || !IsValid(AbilitySystemComponent))
+	{
+		return FActiveGameplayEffectHandle();
+	}
+
+	// The template has no context, so only the context and source captures are per character
+	FGameplayEffectSpec Spec(*Template);
+	Spec.SetContext(EffectContext, true);
+	Spec.CaptureDataFromSource();
+
+	return AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(Spec);
+}
+
 void AVTCharacterBase::ShowDamageNumber()
 {
-	if (DamageNumberQueue.Num() > 0 && IsValid(this))
+#if !UE_SERVER
+	if (DamageNumberQueueNum > 0)
 	{
-		UVTDamageTextWidgetComponent* DamageText = NewObject<UVTDamageTextWidgetComponent>(this, DamageNumberClass);
-		DamageText->RegisterComponent();
-		DamageText->AttachToComponent(GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
-		DamageText->SetDamageText(DamageNumberQueue[0].DamageAmount, DamageNumberQueue[0].Tags);
+		FVTDamageNumber& Next = DamageNumberQueue[DamageNumberQueueHead];
 
-		if (DamageNumberQueue.Num() < 1)
+		if (UVTDamageNumberPoolSubsystem* Pool = GetWorld()->GetSubsystem<UVTDamageNumberPoolSubsystem>())
 		{
-			GetWorldTimerManager().ClearTimer(DamageNumberTimer);
+			LastDamageText = Pool->ShowDamageNumber(this, DamageNumberClass, Next.DamageAmount, Next.Tags);
 		}
 
-		DamageNumberQueue.RemoveAt(0);
+		Next.Tags.Reset();
+		DamageNumberQueueHead = (DamageNumberQueueHead + 1) % DamageNumberQueueCapacity;
+		--DamageNumberQueueNum;
+	}
+
+	// Check after popping, otherwise the timer keeps running after the last number
+	if (DamageNumberQueueNum == 0)
+	{
+		GetWorldTimerManager().ClearTimer(DamageNumberTimer);
 	}
+#endif
 }
 
 void AVTCharacterBase::SetHealth(float Health)
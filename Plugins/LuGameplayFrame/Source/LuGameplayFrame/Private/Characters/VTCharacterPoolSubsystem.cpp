@@ -0,0 +1,100 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Characters/VTCharacterPoolSubsystem.h"
+#include "Characters/VTCharacterBase.h"
+#include "Engine/World.h"
+#include "LuGameplayFrame.h"
+
+DECLARE_CYCLE_STAT(TEXT("Character Pool Acquire"), STAT_VTCharacterPoolAcquire, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters Reused"), STAT_VTCharactersReused, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Characters Spawned"), STAT_VTCharactersSpawned, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<bool> CVarCharacterPoolEnable(
+	TEXT("VT.CharacterPool.Enable"),
+	true,
+	TEXT("Pool dead characters for respawn instead of destroying them")
+);
+
+static TAutoConsoleVariable<int32> CVarCharacterPoolMaxSize(
+	TEXT("VT.CharacterPool.MaxSize"),
+	16,
+	TEXT("Dead characters kept for reuse, across all classes")
+);
+
+bool UVTCharacterPoolSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	// Only the server spawns characters
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client;
+}
+
+void UVTCharacterPoolSubsystem::Deinitialize()
+{
+	PooledCharacters.Reset();
+	AcquiredClasses.Reset();
+
+	Super::Deinitialize();
+}
+
+AVTCharacterBase* UVTCharacterPoolSubsystem::AcquireCharacter(TSubclassOf<AVTCharacterBase> CharacterClass, const FTransform& SpawnTransform, AActor* Owner)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VTCharacterPoolAcquire);
+
+	if (!CharacterClass)
+	{
+		return nullptr;
+	}
+
+	AcquiredClasses.Add(CharacterClass.Get());
+
+	for (int32 Index = PooledCharacters.Num() - 1; Index >= 0; --Index)
+	{
+		AVTCharacterBase* Character = PooledCharacters[Index];
+		if (!IsValid(Character))
+		{
+			PooledCharacters.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (Character->GetClass() == CharacterClass)
+		{
+			PooledCharacters.RemoveAtSwap(Index);
+			Character->SetOwner(Owner);
+			Character->ReactivateFromPool(SpawnTransform);
+
+			INC_DWORD_STAT(STAT_VTCharactersReused);
+			return Character;
+		}
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	INC_DWORD_STAT(STAT_VTCharactersSpawned);
+	return GetWorld()->SpawnActor<AVTCharacterBase>(CharacterClass, SpawnTransform, SpawnParams);
+}
+
+bool UVTCharacterPoolSubsystem::ReleaseCharacter(AVTCharacterBase* Character)
+{
+	if (!IsPoolingEnabled() || !IsValid(Character) || PooledCharacters.Num() >= CVarCharacterPoolMaxSize.GetValueOnGameThread()
+		|| !AcquiredClasses.Contains(Character->GetClass()))
+	{
+		return false;
+	}
+
+	Character->DeactivateForPool();
+	PooledCharacters.AddUnique(Character);
+	return true;
+}
+
+bool UVTCharacterPoolSubsystem::IsPoolingEnabled()
+{
+	return CVarCharacterPoolEnable.GetValueOnGameThread();
+}
@@ -0,0 +1,169 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Characters/VTSignificanceSubsystem.h"
+#include "Characters/VTCharacterBase.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "LuGameplayFrame.h"
+#include "SignificanceManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Significance Update"), STAT_VTSignificanceUpdate, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<float> CVarSignificanceHighDistance(
+	TEXT("VT.Significance.HighDistance"),
+	2000.0f,
+	TEXT("Remote characters closer than this are always High significance")
+);
+
+static TAutoConsoleVariable<float> CVarSignificanceMaxDistance(
+	TEXT("VT.Significance.MaxDistance"),
+	10000.0f,
+	TEXT("Remote characters further than this are Off unless they are in combat")
+);
+
+static TAutoConsoleVariable<float> CVarSignificanceOffscreenScale(
+	TEXT("VT.Significance.OffscreenScale"),
+	0.5f,
+	TEXT("Significance multiplier for characters behind the view direction")
+);
+
+static TAutoConsoleVariable<float> CVarSignificanceCombatWindow(
+	TEXT("VT.Significance.CombatWindow"),
+	3.0f,
+	TEXT("Seconds after combat activity during which a character keeps at least Medium significance")
+);
+
+FName UVTSignificanceSubsystem::CharacterSignificanceTag(TEXT("VTCharacter"));
+
+bool UVTSignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_SERVER
+	return false;
+#else
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	// Dedicated servers have no viewpoints to rank against
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->GetNetMode() != NM_DedicatedServer && World->IsGameWorld();
+#endif
+}
+
+void UVTSignificanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VTSignificanceUpdate);
+
+	UWorld* World = GetWorld();
+	USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(World);
+	if (!SignificanceManager)
+	{
+		return;
+	}
+
+	Viewpoints.Reset();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			Viewpoints.Emplace(ViewRotation, ViewLocation);
+		}
+	}
+
+	SignificanceManager->Update(Viewpoints);
+}
+
+TStatId UVTSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVTSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UVTSignificanceSubsystem::RegisterCharacter(AVTCharacterBase* Character)
+{
+	USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld());
+	if (!SignificanceManager || !Character)
+	{
+		return;
+	}
+
+	auto SignificanceFunction = [](USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint) -> float
+	{
+		return CalculateSignificance(CastChecked<AVTCharacterBase>(ObjectInfo->GetObject()), Viewpoint);
+	};
+
+	auto PostSignificanceFunction = [](USignificanceManager::FManagedObjectInfo* ObjectInfo, float OldSignificance, float Significance, bool bFinal)
+	{
+		AVTCharacterBase* Character = CastChecked<AVTCharacterBase>(ObjectInfo->GetObject());
+		const EVTSignificanceTier NewTier = GetTierForSignificance(Significance);
+		if (Character->GetSignificanceTier() != NewTier)
+		{
+			Character->SetSignificanceTier(NewTier);
+		}
+	};
+
+	SignificanceManager->RegisterObject(Character, CharacterSignificanceTag, SignificanceFunction, USignificanceManager::EPostSignificanceType::Sequential, PostSignificanceFunction);
+}
+
+void UVTSignificanceSubsystem::UnregisterCharacter(AVTCharacterBase* Character)
+{
+	USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(GetWorld());
+	if (SignificanceManager && Character)
+	{
+		SignificanceManager->UnregisterObject(Character);
+	}
+}
+
+float UVTSignificanceSubsystem::CalculateSignificance(const AVTCharacterBase* Character, const FTransform& Viewpoint)
+{
+	// Our own characters are always fully significant
+	if (Character->IsLocallyControlled())
+	{
+		return 1.0f;
+	}
+
+	const FVector ToCharacter = Character->GetActorLocation() - Viewpoint.GetLocation();
+	const float Distance = ToCharacter.Size();
+	const float HighDistance = CVarSignificanceHighDistance.GetValueOnGameThread();
+	const float MaxDistance = FMath::Max(CVarSignificanceMaxDistance.GetValueOnGameThread(), HighDistance + 1.0f);
+
+	// 1 inside HighDistance, falling off linearly to 0 at MaxDistance
+	float Significance = 1.0f - FMath::Clamp((Distance - HighDistance) / (MaxDistance - HighDistance), 0.0f, 1.0f);
+
+	if (Distance > HighDistance && (ToCharacter | Viewpoint.GetRotation().GetForwardVector()) < 0.0f)
+	{
+		Significance *= CVarSignificanceOffscreenScale.GetValueOnGameThread();
+	}
+
+	// Anyone fighting stays at least Medium so shots and hits animate properly
+	const UWorld* World = Character->GetWorld();
+	if (World && World->GetTimeSeconds() - Character->GetLastCombatTime() < CVarSignificanceCombatWindow.GetValueOnGameThread())
+	{
+		Significance = FMath::Max(Significance, 0.5f);
+	}
+
+	return Significance;
+}
+
+EVTSignificanceTier UVTSignificanceSubsystem::GetTierForSignificance(float Significance)
+{
+	if (Significance >= 0.75f)
+	{
+		return EVTSignificanceTier::High;
+	}
+	else if (Significance >= 0.4f)
+	{
+		return EVTSignificanceTier::Medium;
+	}
+	else if (Significance > 0.0f)
+	{
+		return EVTSignificanceTier::Low;
+	}
+
+	return EVTSignificanceTier::Off;
+}
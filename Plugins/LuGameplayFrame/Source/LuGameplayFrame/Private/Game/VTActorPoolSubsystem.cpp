@@ -0,0 +1,122 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Game/VTActorPoolSubsystem.h"
+#include "Engine/World.h"
+#include "Game/VTPooledActorInterface.h"
+#include "LuGameplayFrame.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Actors Reused"), STAT_VTPooledActorsReused, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pooled Actors Spawned"), STAT_VTPooledActorsSpawned, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<int32> CVarActorPoolMaxFree(
+	TEXT("VT.ActorPool.MaxFree"),
+	128,
+	TEXT("Released actors kept for reuse, across all classes")
+);
+
+void UVTActorPoolSubsystem::Deinitialize()
+{
+	ActiveActors.Reset();
+	FreeActors.Reset();
+
+	Super::Deinitialize();
+}
+
+AActor* UVTActorPoolSubsystem::AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, const FActorSpawnParameters& SpawnParams)
+{
+	if (!ActorClass)
+	{
+		return nullptr;
+	}
+
+	for (int32 Index = FreeActors.Num() - 1; Index >= 0; --Index)
+	{
+		AActor* Actor = FreeActors[Index];
+		if (!IsValid(Actor))
+		{
+			FreeActors.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (Actor->GetClass() == ActorClass)
+		{
+			FreeActors.RemoveAtSwap(Index);
+
+			Actor->SetOwner(SpawnParams.Owner);
+			Actor->SetInstigator(SpawnParams.Instigator);
+			Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+			Actor->SetActorHiddenInGame(false);
+			Actor->SetActorEnableCollision(true);
+			Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+
+			if (IVTPooledActorInterface* PooledActor = Cast<IVTPooledActorInterface>(Actor))
+			{
+				PooledActor->OnAcquiredFromPool();
+			}
+
+			ActiveActors.Add(Actor);
+			INC_DWORD_STAT(STAT_VTPooledActorsReused);
+			return Actor;
+		}
+	}
+
+	AActor* Actor = GetWorld()->SpawnActor<AActor>(ActorClass, Transform, SpawnParams);
+	if (Actor)
+	{
+		ActiveActors.Add(Actor);
+		INC_DWORD_STAT(STAT_VTPooledActorsSpawned);
+	}
+
+	return Actor;
+}
+
+void UVTActorPoolSubsystem::ReleaseActor(AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	ActiveActors.RemoveSingleSwap(Actor);
+
+	if (FreeActors.Num() >= CVarActorPoolMaxFree.GetValueOnGameThread())
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	if (IVTPooledActorInterface* PooledActor = Cast<IVTPooledActorInterface>(Actor))
+	{
+		PooledActor->OnReleasedToPool();
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+
+	FreeActors.AddUnique(Actor);
+}
+
+void UVTActorPoolSubsystem::ReleaseAllActors()
+{
+	// Copy since ReleaseActor edits ActiveActors
+	TArray<AActor*> ActorsToRelease = MoveTemp(ActiveActors);
+	for (AActor* Actor : ActorsToRelease)
+	{
+		ReleaseActor(Actor);
+	}
+}
+
+bool UVTActorPoolSubsystem::ReleaseToPool(AActor* Actor)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	UVTActorPoolSubsystem* ActorPool = World ? World->GetSubsystem<UVTActorPoolSubsystem>() : nullptr;
+	if (!ActorPool)
+	{
+		return false;
+	}
+
+	ActorPool->ReleaseActor(Actor);
+	return true;
+}
@@ -0,0 +1,60 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Game/VTRoundResetSubsystem.h"
+#include "Characters/VTCharacterBase.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Game/VTActorPoolSubsystem.h"
+#include "LuGameplayFrame.h"
+#include "UObject/UObjectArray.h"
+
+DECLARE_CYCLE_STAT(TEXT("Round Reset"), STAT_VTRoundReset, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<bool> CVarRoundResetLogStats(
+	TEXT("VT.RoundReset.LogStats"),
+	false,
+	TEXT("Log how long each round reset took and how the live UObject count changed since the last one")
+);
+
+bool UVTRoundResetSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client;
+}
+
+void UVTRoundResetSubsystem::ResetRound()
+{
+	SCOPE_CYCLE_COUNTER(STAT_VTRoundReset);
+
+	const double StartTime = FPlatformTime::Seconds();
+	UWorld* World = GetWorld();
+
+	int32 NumCharacters = 0;
+	for (TActorIterator<AVTCharacterBase> It(World); It; ++It)
+	{
+		It->ResetForRound();
+		++NumCharacters;
+	}
+
+	if (UVTActorPoolSubsystem* ActorPool = World->GetSubsystem<UVTActorPoolSubsystem>())
+	{
+		ActorPool->ReleaseAllActors();
+	}
+
+	OnRoundReset.Broadcast(World);
+
+	if (CVarRoundResetLogStats.GetValueOnGameThread())
+	{
+		// Only meaningful once the previous round's garbage has been collected
+		const int32 ObjectCount = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		UE_LOG(LogTemp, Log, TEXT("%s() Reset %d characters in %.2fms. Live UObjects %d (%+d since last reset)"), *FString(__FUNCTION__),
+			NumCharacters, (FPlatformTime::Seconds() - StartTime) * 1000.0, ObjectCount, LastObjectCount > 0 ? ObjectCount - LastObjectCount : 0);
+		LastObjectCount = ObjectCount;
+	}
+}
@@ -1,20 +1,39 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "LuGameplayFrame.h"
+#include "Engine/NetDriver.h"
+#include "Engine/ReplicationDriver.h"
+#include "Engine/World.h"
+#include "Net/VTReplicationGraph.h"
 
 #define LOCTEXT_NAMESPACE "FLuGameplayFrameModule"
 
+static TAutoConsoleVariable<int32> CVarRepGraphEnable(
+	TEXT("VT.RepGraph.Enable"),
+	1,
+	TEXT("Use UVTReplicationGraph for the game net driver. 0 falls back to the engine's default relevancy. Read when the net driver is created."),
+	ECVF_Default
+);
+
 void FLuGameplayFrameModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-	
+	UReplicationDriver::CreateReplicationDriverDelegate().BindLambda([](UNetDriver* ForNetDriver, const FURL& URL, UWorld* World) -> UReplicationDriver*
+	{
+		if (CVarRepGraphEnable.GetValueOnGameThread() == 0 || !World || !World->IsGameWorld() || ForNetDriver->NetDriverName != NAME_GameNetDriver)
+		{
+			return nullptr;
+		}
+
+		return NewObject<UVTReplicationGraph>(GetTransientPackage());
+	});
 }
 
 void FLuGameplayFrameModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	
+	UReplicationDriver::CreateReplicationDriverDelegate().Unbind();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,315 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Net/VTReplicationGraph.h"
+#include "Characters/VTCharacterBase.h"
+#include "Engine/LevelScriptActor.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "GenericTeamAgentInterface.h"
+#include "Net/VTReplicationGraphNode_FogOfWar.h"
+#include "UObject/UObjectIterator.h"
+
+static TAutoConsoleVariable<int32> CVarFogOfWarEnable(
+	TEXT("VT.FogOfWar.Enable"),
+	0,
+	TEXT("Cull enemy characters that no viewer on a connection can see. Read when the replication graph is created.")
+);
+
+UVTReplicationGraph::UVTReplicationGraph()
+{
+	SpatialGridCellSize = 10000.0f;
+	SpatialGridBias = FVector2D(-150000.0f, -200000.0f);
+	DefaultCullDistance = 15000.0f;
+
+	GridNode = nullptr;
+	AlwaysRelevantNode = nullptr;
+	FogOfWarNode = nullptr;
+}
+
+void UVTReplicationGraph::ResetGameWorldState()
+{
+	Super::ResetGameWorldState();
+
+	AllCharacters.Reset();
+	TeamActorLists.Reset();
+}
+
+void UVTReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Config overrides first so they win over the defaults below
+	for (const FVTRepGraphClassSettings& Settings : ClassSettings)
+	{
+		if (UClass* ActorClass = Settings.ActorClass.TryLoadClass<AActor>())
+		{
+			ClassRepNodePolicies.Set(ActorClass, Settings.NodeMapping);
+		}
+	}
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (!ActorCDO || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// Skip Blueprint compile leftovers
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		const EVTClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+
+		FClassReplicationInfo ClassInfo;
+		ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(ActorCDO->NetUpdateFrequency);
+		if (Mapping >= EVTClassRepNodeMapping::Spatialize_Static)
+		{
+			// The engine default cull distance is very large, cap it for the grid
+			const float CullDistanceSquared = ActorCDO->NetCullDistanceSquared > 0.0f ? ActorCDO->NetCullDistanceSquared : FMath::Square(DefaultCullDistance);
+			ClassInfo.SetCullDistanceSquared(FMath::Min(CullDistanceSquared, FMath::Square(DefaultCullDistance)));
+		}
+
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UVTReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = SpatialGridCellSize;
+	GridNode->SpatialBias = SpatialGridBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	if (CVarFogOfWarEnable.GetValueOnGameThread() != 0)
+	{
+		FogOfWarNode = CreateNewNode<UVTReplicationGraphNode_FogOfWar>();
+		AddGlobalGraphNode(FogOfWarNode);
+	}
+}
+
+void UVTReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// Viewer's controller and pawn
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(AlwaysRelevantForConnectionNode, RepGraphConnection);
+
+	UVTReplicationGraphNode_AlwaysRelevant_ForTeam* TeamNode = CreateNewNode<UVTReplicationGraphNode_AlwaysRelevant_ForTeam>();
+	AddConnectionGraphNode(TeamNode, RepGraphConnection);
+
+	if (FogOfWarNode)
+	{
+		UVTReplicationGraphNode_FogOfWar_ForConnection* FogOfWarConnectionNode = CreateNewNode<UVTReplicationGraphNode_FogOfWar_ForConnection>();
+		FogOfWarConnectionNode->FogOfWarNode = FogOfWarNode;
+		AddConnectionGraphNode(FogOfWarConnectionNode, RepGraphConnection);
+	}
+}
+
+void UVTReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if (ActorInfo.Actor->IsA<AVTCharacterBase>())
+	{
+		AllCharacters.Add(ActorInfo.Actor);
+
+		if (FogOfWarNode)
+		{
+			FogOfWarNode->NotifyAddNetworkActor(ActorInfo);
+			return;
+		}
+	}
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EVTClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EVTClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EVTClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EVTClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+void UVTReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	if (ActorInfo.Actor->IsA<AVTCharacterBase>())
+	{
+		AllCharacters.RemoveFast(ActorInfo.Actor);
+
+		if (FogOfWarNode)
+		{
+			FogOfWarNode->NotifyRemoveNetworkActor(ActorInfo);
+			return;
+		}
+	}
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EVTClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EVTClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EVTClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EVTClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	default:
+		break;
+	}
+}
+
+int32 UVTReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+	// Teams can change at any time (possession, team swap), so resolve them once per frame instead of per connection
+	RebuildTeamActorLists();
+
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
+
+FActorRepListRefView* UVTReplicationGraph::GetTeamActorList(uint8 TeamId)
+{
+	return TeamActorLists.Find(TeamId);
+}
+
+uint8 UVTReplicationGraph::GetTeamForActor(const AActor* Actor)
+{
+	uint8 TeamId = FGenericTeamId::GetTeamIdentifier(Actor);
+	if (TeamId != FGenericTeamId::NoTeam)
+	{
+		return TeamId;
+	}
+
+	if (const APawn* Pawn = Cast<APawn>(Actor))
+	{
+		TeamId = FGenericTeamId::GetTeamIdentifier(Pawn->GetController());
+		if (TeamId == FGenericTeamId::NoTeam)
+		{
+			TeamId = FGenericTeamId::GetTeamIdentifier(Pawn->GetPlayerState());
+		}
+	}
+	else if (const AController* Controller = Cast<AController>(Actor))
+	{
+		TeamId = FGenericTeamId::GetTeamIdentifier(Controller->PlayerState);
+		if (TeamId == FGenericTeamId::NoTeam)
+		{
+			// Viewers are player controllers, AVTCharacterBase carries the team
+			TeamId = FGenericTeamId::GetTeamIdentifier(Controller->GetPawn());
+		}
+	}
+
+	return TeamId;
+}
+
+EVTClassRepNodeMapping UVTReplicationGraph::GetMappingPolicy(const UClass* Class)
+{
+	if (const EVTClassRepNodeMapping* Mapping = ClassRepNodePolicies.Get(Class))
+	{
+		return *Mapping;
+	}
+
+	const EVTClassRepNodeMapping Mapping = GetDefaultMappingPolicy(Class);
+	ClassRepNodePolicies.Set(Class, Mapping);
+	return Mapping;
+}
+
+EVTClassRepNodeMapping UVTReplicationGraph::GetDefaultMappingPolicy(const UClass* Class) const
+{
+	const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+	if (!ActorCDO || !ActorCDO->GetIsReplicated())
+	{
+		return EVTClassRepNodeMapping::NotRouted;
+	}
+
+	if (Class->IsChildOf<AVTCharacterBase>())
+	{
+		return EVTClassRepNodeMapping::Spatialize_Dynamic;
+	}
+
+	if (Class->IsChildOf<APlayerState>() || Class->IsChildOf<AGameStateBase>() || Class->IsChildOf<ALevelScriptActor>())
+	{
+		return EVTClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	// Owner only actors come through UReplicationGraphNode_AlwaysRelevant_ForConnection or as dependents of their owner
+	if (ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EVTClassRepNodeMapping::NotRouted;
+	}
+
+	if (ActorCDO->bAlwaysRelevant)
+	{
+		return EVTClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	// Pickups and other actors that sit still until something happens to them
+	if (ActorCDO->NetDormancy >= DORM_DormantAll)
+	{
+		return EVTClassRepNodeMapping::Spatialize_Dormancy;
+	}
+
+	if (ActorCDO->IsReplicatingMovement())
+	{
+		return EVTClassRepNodeMapping::Spatialize_Dynamic;
+	}
+
+	return EVTClassRepNodeMapping::Spatialize_Static;
+}
+
+void UVTReplicationGraph::RebuildTeamActorLists()
+{
+	for (TPair<uint8, FActorRepListRefView>& TeamList : TeamActorLists)
+	{
+		TeamList.Value.Reset();
+	}
+
+	for (AActor* Character : AllCharacters)
+	{
+		const uint8 TeamId = GetTeamForActor(Character);
+		if (TeamId != FGenericTeamId::NoTeam)
+		{
+			TeamActorLists.FindOrAdd(TeamId).Add(Character);
+		}
+	}
+}
+
+void UVTReplicationGraphNode_AlwaysRelevant_ForTeam::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	UVTReplicationGraph* Graph = CastChecked<UVTReplicationGraph>(GetOuter());
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		const uint8 TeamId = UVTReplicationGraph::GetTeamForActor(Viewer.InViewer);
+		if (TeamId == FGenericTeamId::NoTeam)
+		{
+			continue;
+		}
+
+		FActorRepListRefView* TeamList = Graph->GetTeamActorList(TeamId);
+		if (TeamList && TeamList->Num() > 0)
+		{
+			Params.OutGatheredReplicationLists.AddReplicationActorList(*TeamList);
+		}
+	}
+}
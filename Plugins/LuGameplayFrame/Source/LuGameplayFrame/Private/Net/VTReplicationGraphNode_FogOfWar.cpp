@@ -0,0 +1,311 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Net/VTReplicationGraphNode_FogOfWar.h"
+#include "Engine/World.h"
+#include "GenericTeamAgentInterface.h"
+#include "LuGameplayFrame.h"
+#include "Net/VTReplicationGraph.h"
+#include "Visibility/VTPotentialVisibilitySubsystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("FogOfWar Traces"), STAT_VTFogOfWarTraces, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FogOfWar Traces"), STAT_VTFogOfWarTraceCount, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FogOfWar PVS Rejects"), STAT_VTFogOfWarPVSRejects, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FogOfWar Culled Pairs"), STAT_VTFogOfWarCulledCount, STATGROUP_LuGameplayFrame);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("FogOfWar Estimated Bytes Saved"), STAT_VTFogOfWarBytesSaved, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<int32> CVarFogOfWarTracesPerFrame(
+	TEXT("VT.FogOfWar.PairsPerFrame"),
+	64,
+	TEXT("How many (viewer, enemy) pairs get a line of sight update per server frame")
+);
+
+static TAutoConsoleVariable<float> CVarFogOfWarGraceTime(
+	TEXT("VT.FogOfWar.GraceTime"),
+	0.5f,
+	TEXT("Seconds an enemy stays relevant after the last trace that could see it")
+);
+
+static TAutoConsoleVariable<float> CVarFogOfWarAlwaysVisibleDistance(
+	TEXT("VT.FogOfWar.AlwaysVisibleDistance"),
+	1500.0f,
+	TEXT("Enemies closer than this are always relevant (footsteps, peeking around corners)")
+);
+
+static TAutoConsoleVariable<float> CVarFogOfWarMaxDistance(
+	TEXT("VT.FogOfWar.MaxDistance"),
+	15000.0f,
+	TEXT("Enemies further than this are never relevant")
+);
+
+static TAutoConsoleVariable<float> CVarFogOfWarLeadTime(
+	TEXT("VT.FogOfWar.LeadTime"),
+	0.2f,
+	TEXT("Targets are extrapolated by their velocity for this long before tracing so they show up before they round a corner")
+);
+
+static TAutoConsoleVariable<float> CVarFogOfWarBytesPerUpdate(
+	TEXT("VT.FogOfWar.EstimatedBytesPerUpdate"),
+	48.0f,
+	TEXT("Average size of one character update (movement, montage, attributes), used to estimate the bandwidth culling saves")
+);
+
+static TAutoConsoleVariable<int32> CVarFogOfWarLogStats(
+	TEXT("VT.FogOfWar.LogStats"),
+	0,
+	TEXT("Log traces per second and culled pairs per second")
+);
+
+UVTReplicationGraphNode_FogOfWar::UVTReplicationGraphNode_FogOfWar()
+{
+	bRequiresPrepareForReplicationCall = true;
+
+	NextPairToTrace = 0;
+	TracesThisSecond = 0;
+	CulledThisSecond = 0;
+	BytesSavedThisSecond = 0.0;
+	StatsWindowStart = 0.0;
+}
+
+void UVTReplicationGraphNode_FogOfWar::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Characters.Add(ActorInfo.Actor);
+}
+
+bool UVTReplicationGraphNode_FogOfWar::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	// Pairs pointing at this actor are dropped by the trace sweep once the weak pointer goes stale
+	return Characters.RemoveFast(ActorInfo.Actor);
+}
+
+void UVTReplicationGraphNode_FogOfWar::NotifyResetAllNetworkActors()
+{
+	Characters.Reset();
+	Pairs.Reset();
+	PairIndices.Reset();
+	NextPairToTrace = 0;
+}
+
+void UVTReplicationGraphNode_FogOfWar::PrepareForReplication()
+{
+	SCOPE_CYCLE_COUNTER(STAT_VTFogOfWarTraces);
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	const double Now = World->GetTimeSeconds();
+
+	if (Now - StatsWindowStart >= 1.0)
+	{
+		if (CVarFogOfWarLogStats.GetValueOnGameThread() != 0)
+		{
+			UE_LOG(LogTemp, Log, TEXT("%s() %d traces/s, %d culled (viewer, enemy) pairs/s, ~%.0f bytes/s saved, %d tracked pairs"), *FString(__FUNCTION__),
+				TracesThisSecond, CulledThisSecond, BytesSavedThisSecond, Pairs.Num());
+		}
+
+		TracesThisSecond = 0;
+		CulledThisSecond = 0;
+		BytesSavedThisSecond = 0.0;
+		StatsWindowStart = Now;
+	}
+
+	const int32 Budget = CVarFogOfWarTracesPerFrame.GetValueOnGameThread();
+	int32 Traced = 0;
+	int32 Checked = 0;
+	const int32 NumToCheck = Pairs.Num();
+
+	while (Traced < Budget && Checked < NumToCheck && Pairs.Num() > 0)
+	{
+		++Checked;
+
+		if (NextPairToTrace >= Pairs.Num())
+		{
+			NextPairToTrace = 0;
+		}
+
+		FVTFogOfWarPair& Pair = Pairs[NextPairToTrace];
+
+		// Nobody asked for this pair in a while (enemy out of range, viewer left) or one side is gone
+		if (!Pair.Viewer.IsValid() || !Pair.Target.IsValid() || Now - Pair.LastQueriedTime > 2.0)
+		{
+			RemovePairAt(NextPairToTrace);
+			continue;
+		}
+
+		if (TracePair(World, Pair))
+		{
+			Pair.LastVisibleTime = Now;
+		}
+
+		++Traced;
+		++NextPairToTrace;
+	}
+}
+
+void UVTReplicationGraphNode_FogOfWar::GatherVisibleEnemies(const FConnectionGatherActorListParameters& Params, FActorRepListRefView& OutList)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	const double Now = World->GetTimeSeconds();
+	const float GraceTime = CVarFogOfWarGraceTime.GetValueOnGameThread();
+	const float AlwaysVisibleDistanceSquared = FMath::Square(CVarFogOfWarAlwaysVisibleDistance.GetValueOnGameThread());
+	const float MaxDistanceSquared = FMath::Square(CVarFogOfWarMaxDistance.GetValueOnGameThread());
+	const float BytesPerUpdate = CVarFogOfWarBytesPerUpdate.GetValueOnGameThread();
+
+	for (const FNetViewer& Viewer : Params.Viewers)
+	{
+		AActor* ViewerActor = Viewer.ViewTarget ? Viewer.ViewTarget : Viewer.InViewer;
+		const uint8 ViewerTeam = UVTReplicationGraph::GetTeamForActor(Viewer.InViewer);
+
+		for (AActor* Target : Characters)
+		{
+			// Own pawn and teammates come from the connection and team nodes
+			if (Target == ViewerActor || (ViewerTeam != FGenericTeamId::NoTeam && UVTReplicationGraph::GetTeamForActor(Target) == ViewerTeam))
+			{
+				continue;
+			}
+
+			const float DistanceSquared = FVector::DistSquared(Target->GetActorLocation(), Viewer.ViewLocation);
+			if (DistanceSquared > MaxDistanceSquared)
+			{
+				continue;
+			}
+
+			if (DistanceSquared < AlwaysVisibleDistanceSquared)
+			{
+				OutList.Add(Target);
+				continue;
+			}
+
+			FVTFogOfWarPair& Pair = FindOrAddPair(ViewerActor, Target, Now);
+			Pair.ViewLocation = Viewer.ViewLocation;
+			Pair.LastQueriedTime = Now;
+
+			if (Now - Pair.LastVisibleTime <= GraceTime)
+			{
+				OutList.Add(Target);
+			}
+			else
+			{
+				++CulledThisSecond;
+				INC_DWORD_STAT(STAT_VTFogOfWarCulledCount);
+
+				// A culled gather only saves an update on frames the target would have replicated to this connection
+				const float BytesSaved = BytesPerUpdate * FMath::Min(1.0f, Target->NetUpdateFrequency * World->GetDeltaSeconds());
+				BytesSavedThisSecond += BytesSaved;
+				INC_FLOAT_STAT_BY(STAT_VTFogOfWarBytesSaved, BytesSaved);
+			}
+		}
+	}
+
+}
+
+FVTFogOfWarPair& UVTReplicationGraphNode_FogOfWar::FindOrAddPair(AActor* Viewer, AActor* Target, double Now)
+{
+	const TPair<AActor*, AActor*> Key(Viewer, Target);
+	if (const int32* Index = PairIndices.Find(Key))
+	{
+		FVTFogOfWarPair& Found = Pairs[*Index];
+		if (Found.Viewer.Get() == Viewer && Found.Target.Get() == Target)
+		{
+			return Found;
+		}
+
+		// One side was destroyed and a new actor got its address before the sweep dropped the pair
+		Found.Viewer = Viewer;
+		Found.Target = Target;
+		Found.LastVisibleTime = Now;
+		return Found;
+	}
+
+	const int32 NewIndex = Pairs.AddDefaulted();
+	FVTFogOfWarPair& Pair = Pairs[NewIndex];
+	Pair.Key = Key;
+	Pair.Viewer = Viewer;
+	Pair.Target = Target;
+	// Conservative: a pair we haven't traced yet counts as visible
+	Pair.LastVisibleTime = Now;
+	PairIndices.Add(Key, NewIndex);
+
+	return Pair;
+}
+
+bool UVTReplicationGraphNode_FogOfWar::TracePair(UWorld* World, const FVTFogOfWarPair& Pair)
+{
+	AActor* Target = Pair.Target.Get();
+
+	float Radius = 0.0f;
+	float HalfHeight = 0.0f;
+	Target->GetSimpleCollisionCylinder(Radius, HalfHeight);
+
+	const FVector Center = Target->GetActorLocation() + Target->GetVelocity() * CVarFogOfWarLeadTime.GetValueOnGameThread();
+	const FVector ToTarget = (Center - Pair.ViewLocation).GetSafeNormal2D();
+	const FVector Side(-ToTarget.Y, ToTarget.X, 0.0f);
+
+	// The baked PVS rules out most pairs across the map without tracing
+	const UVTPotentialVisibilitySubsystem* PVS = World->GetSubsystem<UVTPotentialVisibilitySubsystem>();
+	if (PVS && !PVS->IsPotentiallyVisible(Pair.ViewLocation, Center))
+	{
+		INC_DWORD_STAT(STAT_VTFogOfWarPVSRejects);
+		return false;
+	}
+
+	// Widen the sides past the capsule so shoulders and weapons sticking out around corners still count
+	const FVector TestPoints[] =
+	{
+		Center + FVector(0.0f, 0.0f, HalfHeight * 0.9f),
+		Center,
+		Center + Side * Radius * 2.0f,
+		Center - Side * Radius * 2.0f
+	};
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VTFogOfWar), false);
+	QueryParams.AddIgnoredActor(Pair.Viewer.Get());
+	QueryParams.AddIgnoredActor(Target);
+
+	for (const FVector& TestPoint : TestPoints)
+	{
+		++TracesThisSecond;
+		INC_DWORD_STAT(STAT_VTFogOfWarTraceCount);
+
+		if (!World->LineTraceTestByChannel(Pair.ViewLocation, TestPoint, ECC_Visibility, QueryParams))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UVTReplicationGraphNode_FogOfWar::RemovePairAt(int32 Index)
+{
+	PairIndices.Remove(Pairs[Index].Key);
+	Pairs.RemoveAtSwap(Index);
+
+	if (Pairs.IsValidIndex(Index))
+	{
+		PairIndices.Add(Pairs[Index].Key, Index);
+	}
+}
+
+void UVTReplicationGraphNode_FogOfWar_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	VisibleEnemies.Reset();
+
+	if (FogOfWarNode)
+	{
+		FogOfWarNode->GatherVisibleEnemies(Params, VisibleEnemies);
+	}
+
+	if (VisibleEnemies.Num() > 0)
+	{
+		Params.OutGatheredReplicationLists.AddReplicationActorList(VisibleEnemies);
+	}
+}
@@ -0,0 +1,139 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Player/VTDamageNumberBatchComponent.h"
+#include "Characters/VTCharacterBase.h"
+#include "UObject/CoreNet.h"
+#include "GameFramework/PlayerController.h"
+#include "LuGameplayFrame.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Queued"), STAT_VTDamageNumbersQueued, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Number RPCs"), STAT_VTDamageNumberRPCs, STATGROUP_LuGameplayFrame);
+
+bool FVTDamageNumberBatchEntry::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	UObject* TargetObject = Target;
+	bOutSuccess &= Map->SerializeObject(Ar, AActor::StaticClass(), TargetObject);
+	if (Ar.IsLoading())
+	{
+		Target = Cast<AActor>(TargetObject);
+	}
+
+	Ar.SerializeIntPacked(QuantizedDamage);
+
+	// Most hits have no tags
+	uint8 bHasTags = Tags.Num() > 0;
+	Ar.SerializeBits(&bHasTags, 1);
+	if (bHasTags)
+	{
+		bool bTagsSuccess = true;
+		Tags.NetSerialize(Ar, Map, bTagsSuccess);
+		bOutSuccess &= bTagsSuccess;
+	}
+	else if (Ar.IsLoading())
+	{
+		Tags.Reset();
+	}
+
+	return true;
+}
+
+UVTDamageNumberBatchComponent::UVTDamageNumberBatchComponent()
+{
+	// Flush after everything that can deal damage this frame has run
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void UVTDamageNumberBatchComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	FlushDamageNumbers();
+}
+
+void UVTDamageNumberBatchComponent::QueueDamageNumber(AController* Controller, float Damage, AActor* Target, const FGameplayTagContainer& DamageNumberTags)
+{
+	APlayerController* PC = Cast<APlayerController>(Controller);
+	if (!PC || !PC->HasAuthority())
+	{
+		return;
+	}
+
+	UVTDamageNumberBatchComponent* Batch = PC->FindComponentByClass<UVTDamageNumberBatchComponent>();
+	if (!Batch)
+	{
+		Batch = NewObject<UVTDamageNumberBatchComponent>(PC, TEXT("DamageNumberBatch"));
+		Batch->RegisterComponent();
+	}
+
+	Batch->AddDamageNumber(Damage, Target, DamageNumberTags);
+}
+
+void UVTDamageNumberBatchComponent::AddDamageNumber(float Damage, AActor* Target, const FGameplayTagContainer& DamageNumberTags)
+{
+	INC_DWORD_STAT(STAT_VTDamageNumbersQueued);
+
+	// A shotgun blast or a burst on one target becomes one number. Headshot if any of it was.
+	for (FPendingDamageNumber& Pending : PendingDamageNumbers)
+	{
+		if (Pending.Target == Target)
+		{
+			Pending.Damage += Damage;
+			Pending.Tags.AppendTags(DamageNumberTags);
+			return;
+		}
+	}
+
+	FPendingDamageNumber& Pending = PendingDamageNumbers.AddDefaulted_GetRef();
+	Pending.Target = Target;
+	Pending.Damage = Damage;
+	Pending.Tags = DamageNumberTags;
+
+	SetComponentTickEnabled(true);
+}
+
+void UVTDamageNumberBatchComponent::FlushDamageNumbers()
+{
+	SetComponentTickEnabled(false);
+
+	OutgoingBatch.Reset(PendingDamageNumbers.Num());
+	for (FPendingDamageNumber& Pending : PendingDamageNumbers)
+	{
+		if (!Pending.Target.IsValid())
+		{
+			continue;
+		}
+
+		FVTDamageNumberBatchEntry& Entry = OutgoingBatch.AddDefaulted_GetRef();
+		Entry.Target = Pending.Target.Get();
+		Entry.QuantizedDamage = static_cast<uint32>(FMath::Max(FMath::RoundToInt(Pending.Damage * 10.0f), 0));
+		Entry.Tags = MoveTemp(Pending.Tags);
+	}
+	PendingDamageNumbers.Reset();
+
+	if (OutgoingBatch.Num() > 0)
+	{
+		INC_DWORD_STAT(STAT_VTDamageNumberRPCs);
+		ClientShowDamageNumbers(OutgoingBatch);
+	}
+}
+
+void UVTDamageNumberBatchComponent::ClientShowDamageNumbers_Implementation(const TArray<FVTDamageNumberBatchEntry>& DamageNumbers)
+{
+#if !UE_SERVER
+	for (const FVTDamageNumberBatchEntry& Entry : DamageNumbers)
+	{
+		// Target may not be relevant to us anymore
+		if (AVTCharacterBase* TargetCharacter = Cast<AVTCharacterBase>(Entry.Target))
+		{
+			TargetCharacter->AddDamageNumber(Entry.GetDamage(), Entry.Tags);
+		}
+	}
+#endif
+}
@@ -0,0 +1,73 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
+#include "Characters/Abilities/GSAbilitySystemGlobals.h"
+#include "Characters/Abilities/GSGameplayAbility.h"
+#include "Tests/VTTestWorld.h"
+#include "VTGameplayTags.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTAbilityNativeCostTest, "LuGameplayFrame.Abilities.NativeCost.TenThousandChecks",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTAbilityNativeCostTest::RunTest(const FString& Parameters)
+{
+	// Rifle, rocket and shotgun in slots 0-2
+	UGSAmmoAttributeSet::InitAmmoTypes(nullptr);
+
+	{
+		FVTScopedTestWorld TestWorld;
+		const TSubclassOf<UAttributeSet> AttributeSets[] = { UGSAmmoAttributeSet::StaticClass() };
+		UGSAbilitySystemComponent* ASC = TestWorld.SpawnAbilityActor(AttributeSets);
+		FGameplayTag RifleAmmoTag = VTGameplayTags::Weapon_Ammo_Rifle;
+		const FGameplayAttribute RifleAmmo = UGSAmmoAttributeSet::GetReserveAmmoAttributeFromTag(RifleAmmoTag);
+		ASC->SetNumericAttributeBase(RifleAmmo, 30.0f);
+
+		UGSGameplayAbility* Ability = NewObject<UGSGameplayAbility>(ASC->GetOwner());
+		Ability->NativeCost.CostType = EGSAbilityCostType::ReserveAmmo;
+		Ability->NativeCost.AmmoTag = RifleAmmoTag;
+		Ability->NativeCost.Amount = 1;
+
+		const FGameplayAbilitySpecHandle Handle;
+		const FGameplayAbilityActorInfo* ActorInfo = ASC->AbilityActorInfo.Get();
+		constexpr int32 NumChecks = 10000;
+
+		// GSCheckCost is what CheckCost used to call for every ability, through ProcessEvent
+		int32 NumPassedProcessEvent = 0;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumChecks; Index++)
+		{
+			NumPassedProcessEvent += Ability->GSCheckCost(Handle, *ActorInfo) ? 1 : 0;
+		}
+		const double ProcessEventMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		int32 NumPassedNative = 0;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumChecks; Index++)
+		{
+			NumPassedNative += Ability->CheckCost(Handle, ActorInfo) ? 1 : 0;
+		}
+		const double NativeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		// Timings are informational only, the assertions are on the results
+		AddInfo(FString::Printf(TEXT("%d cost checks: through ProcessEvent %.3fms, native %.3fms"), NumChecks, ProcessEventMs, NativeMs));
+		TestEqual(TEXT("Native checks passed"), NumPassedNative, NumChecks);
+		TestEqual(TEXT("Both paths agree"), NumPassedNative, NumPassedProcessEvent);
+		TestEqual(TEXT("Checks spend nothing"), ASC->GetNumericAttribute(RifleAmmo), 30.0f);
+
+		// The native path still reads the attribute
+		Ability->ApplyCost(Handle, ActorInfo, FGameplayAbilityActivationInfo());
+		TestEqual(TEXT("Reserve ammo after ApplyCost"), ASC->GetNumericAttribute(RifleAmmo), 29.0f);
+		ASC->SetNumericAttributeBase(RifleAmmo, 0.0f);
+		TestFalse(TEXT("Cost check without ammo"), Ability->CheckCost(Handle, ActorInfo));
+	}
+
+	// Back to the project's ammo types
+	UGSAmmoAttributeSet::InitAmmoTypes(Cast<UDataTable>(UGSAbilitySystemGlobals::GSGet().AmmoTypeTableName.TryLoad()));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,79 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/GSGameplayAbility.h"
+#include "Tests/VTTestWorld.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTAbilityInputEdgesTest, "LuGameplayFrame.Abilities.InputEdges.ServerApply",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTAbilityInputEdgesTest::RunTest(const FString& Parameters)
+{
+	// Move edges only apply to specs that opted into direct input replication
+	UGameplayAbility* AbilityCDO = UGSGameplayAbility::StaticClass()->GetDefaultObject<UGameplayAbility>();
+	const bool bOldReplicateInputDirectly = AbilityCDO->bReplicateInputDirectly;
+	VTSetTestProperty(AbilityCDO, TEXT("bReplicateInputDirectly"), true);
+
+	{
+		FVTScopedTestWorld TestWorld;
+		UGSAbilitySystemComponent* ASC = TestWorld.SpawnAbilityActor();
+
+		constexpr int32 InputID = 3;
+		constexpr uint16 InputBit = 1 << InputID;
+		const FGameplayAbilitySpecHandle Handle = ASC->GiveAbility(FGameplayAbilitySpec(UGSGameplayAbility::StaticClass(), 1, InputID));
+		auto GetSpec = [ASC, Handle]() { return ASC->FindAbilitySpecFromHandle(Handle); };
+
+		// A press that overtook the activation RPC waits for the activation
+		ASC->ServerApplyAbilityInputEdges(InputBit, 0, InputBit);
+		TestFalse(TEXT("Edge for an inactive spec is held back"), GetSpec()->InputPressed);
+
+		TestTrue(TEXT("Ability activates"), ASC->TryActivateAbility(Handle));
+		TestFalse(TEXT("Queued edge waits for ActivateAbility to finish"), GetSpec()->InputPressed);
+		TestWorld.TickTimers();
+		TestTrue(TEXT("Queued press applied after activation"), GetSpec()->InputPressed);
+
+		// Press and release inside one move, released at the end
+		ASC->ServerApplyAbilityInputEdges(0, InputBit, 0);
+		ASC->ServerApplyAbilityInputEdges(InputBit, InputBit, 0);
+		TestFalse(TEXT("Tap inside one move ends released"), GetSpec()->InputPressed);
+
+		// Release then press inside one move, held at the end
+		ASC->ServerApplyAbilityInputEdges(InputBit, InputBit, InputBit);
+		TestTrue(TEXT("Re-press inside one move ends pressed"), GetSpec()->InputPressed);
+
+		// Edges for an activation that never comes are dropped
+		ASC->CancelAbilityHandle(Handle);
+		GetSpec()->InputPressed = false;
+		ASC->ServerApplyAbilityInputEdges(InputBit, 0, InputBit);
+		TestWorld.World->TimeSeconds += 2.0;
+		ASC->TryActivateAbility(Handle);
+		TestWorld.TickTimers();
+		TestFalse(TEXT("Stale edge dropped"), GetSpec()->InputPressed);
+
+		// Edges for a rejected activation are dropped with it
+		ASC->CancelAbilityHandle(Handle);
+		GetSpec()->InputPressed = false;
+		ASC->ServerApplyAbilityInputEdges(InputBit, 0, InputBit);
+		ASC->NotifyAbilityFailed(Handle, GetSpec()->Ability, FGameplayTagContainer());
+		ASC->TryActivateAbility(Handle);
+		TestWorld.TickTimers();
+		TestFalse(TEXT("Edge for a rejected activation dropped"), GetSpec()->InputPressed);
+
+		// Another spec on the same input doesn't pick up edges meant for the active one
+		const FGameplayAbilitySpecHandle OtherHandle = ASC->GiveAbility(FGameplayAbilitySpec(UGSGameplayAbility::StaticClass(), 1, InputID));
+		GetSpec()->InputPressed = false;
+		ASC->ServerApplyAbilityInputEdges(InputBit, 0, InputBit);
+		TestTrue(TEXT("Active spec gets the press"), GetSpec()->InputPressed);
+		ASC->TryActivateAbility(OtherHandle);
+		TestWorld.TickTimers();
+		TestFalse(TEXT("Inactive spec on the same input queued nothing"), ASC->FindAbilitySpecFromHandle(OtherHandle)->InputPressed);
+	}
+
+	VTSetTestProperty(AbilityCDO, TEXT("bReplicateInputDirectly"), bOldReplicateInputDirectly);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
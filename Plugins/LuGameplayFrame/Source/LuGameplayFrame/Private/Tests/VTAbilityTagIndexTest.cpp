@@ -0,0 +1,97 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/GSGameplayAbility.h"
+#include "NativeGameplayTags.h"
+#include "Tests/VTTestWorld.h"
+
+namespace VTAbilityTagIndexTest
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ability_Test_Indexed, "Ability.Test.Indexed");
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTAbilityTagIndexTest, "LuGameplayFrame.Abilities.TagIndex.Lookup",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTAbilityTagIndexTest::RunTest(const FString& Parameters)
+{
+	using namespace VTAbilityTagIndexTest;
+
+	// Abilities read their tags from the CDO. Tag UGSGameplayAbility for the test and leave UGameplayAbility untagged.
+	UGameplayAbility* TaggedCDO = UGSGameplayAbility::StaticClass()->GetDefaultObject<UGameplayAbility>();
+	const FGameplayTagContainer OldAbilityTags = *FindFProperty<FStructProperty>(UGameplayAbility::StaticClass(), TEXT("AbilityTags"))->ContainerPtrToValuePtr<FGameplayTagContainer>(TaggedCDO);
+	VTSetTestProperty(TaggedCDO, TEXT("AbilityTags"), FGameplayTagContainer(Ability_Test_Indexed));
+
+	{
+		FVTScopedTestWorld TestWorld;
+		UGSAbilitySystemComponent* ASC = TestWorld.SpawnAbilityActor();
+
+		constexpr int32 NumTagged = 4;
+		constexpr int32 NumUntagged = 60;
+		for (int32 Index = 0; Index < NumTagged + NumUntagged; Index++)
+		{
+			ASC->GiveAbility(FGameplayAbilitySpec(Index < NumTagged ? UGSGameplayAbility::StaticClass() : UGameplayAbility::StaticClass()));
+		}
+
+		const FGameplayTagContainer Tags(Ability_Test_Indexed);
+		constexpr int32 NumLookups = 10000;
+
+		// What the engine's TryActivateAbilitiesByTag does before activating
+		TArray<FGameplayAbilitySpec*> Specs;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumLookups; Index++)
+		{
+			Specs.Reset();
+			ASC->GetActivatableGameplayAbilitySpecsByAllMatchingTags(Tags, Specs);
+		}
+		const double ScanMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		TArray<FGameplayAbilitySpecHandle> Handles;
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < NumLookups; Index++)
+		{
+			Handles.Reset();
+			ASC->GetAbilitySpecHandlesByAllMatchingTags(Tags, Handles);
+		}
+		const double IndexedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		AddInfo(FString::Printf(TEXT("%d tag lookups over %d abilities: scan %.3fms, index %.3fms"), NumLookups, NumTagged + NumUntagged, ScanMs, IndexedMs));
+		TestEqual(TEXT("Scan matches"), Specs.Num(), NumTagged);
+		TestEqual(TEXT("Index matches"), Handles.Num(), NumTagged);
+		for (const FGameplayAbilitySpec* Spec : Specs)
+		{
+			TestTrue(TEXT("Index finds the same specs as the scan"), Handles.Contains(Spec->Handle));
+			TestTrue(TEXT("Handle index finds the spec"), ASC->FindAbilitySpecFromHandleIndexed(Spec->Handle) == Spec);
+		}
+
+		// Items moved behind the index's back are still found, through the scan
+		FGameplayAbilitySpecContainer& ActivatableAbilities = *FindFProperty<FStructProperty>(UAbilitySystemComponent::StaticClass(), TEXT("ActivatableAbilities"))->ContainerPtrToValuePtr<FGameplayAbilitySpecContainer>(ASC);
+		ActivatableAbilities.Items.Swap(0, NumTagged + NumUntagged - 1);
+		const FGameplayAbilitySpecHandle MovedHandle = ActivatableAbilities.Items[0].Handle;
+		TestTrue(TEXT("Moved spec found after a handle mismatch"), ASC->FindAbilitySpecFromHandleIndexed(MovedHandle) == &ActivatableAbilities.Items[0]);
+		ActivatableAbilities.Items.Swap(0, NumTagged + NumUntagged - 1);
+		TestTrue(TEXT("Found again after moving back"), ASC->FindAbilitySpecFromHandleIndexed(MovedHandle) == &ActivatableAbilities.Items.Last());
+
+		// The index follows removals
+		ASC->ClearAbility(Handles[0]);
+		Handles.Reset();
+		ASC->GetAbilitySpecHandlesByAllMatchingTags(Tags, Handles);
+		TestEqual(TEXT("Index matches after a removal"), Handles.Num(), NumTagged - 1);
+
+		// Gameplay events with nothing to trigger go through the cache once per tag
+		int32 NumTriggered = 0;
+		for (int32 Index = 0; Index < NumLookups; Index++)
+		{
+			NumTriggered += ASC->HandleGameplayEvent(Ability_Test_Indexed, nullptr);
+		}
+		TestEqual(TEXT("Nothing triggered"), NumTriggered, 0);
+	}
+
+	VTSetTestProperty(TaggedCDO, TEXT("AbilityTags"), OldAbilityTags);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,100 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
+#include "Characters/Abilities/GSAbilitySystemGlobals.h"
+#include "NativeGameplayTags.h"
+#include "Tests/VTTestWorld.h"
+#include "VTGameplayTags.h"
+
+namespace VTAmmoAttributeSetTest
+{
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo0, "Weapon.Ammo.Test0");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo1, "Weapon.Ammo.Test1");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo2, "Weapon.Ammo.Test2");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo3, "Weapon.Ammo.Test3");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo4, "Weapon.Ammo.Test4");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo5, "Weapon.Ammo.Test5");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo6, "Weapon.Ammo.Test6");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo7, "Weapon.Ammo.Test7");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo8, "Weapon.Ammo.Test8");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo9, "Weapon.Ammo.Test9");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo10, "Weapon.Ammo.Test10");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(Ammo11, "Weapon.Ammo.Test11");
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTAmmoAttributeSetTwelveTypesTest, "LuGameplayFrame.Abilities.AmmoAttributeSet.TwelveAmmoTypes",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTAmmoAttributeSetTwelveTypesTest::RunTest(const FString& Parameters)
+{
+	using namespace VTAmmoAttributeSetTest;
+
+	const FGameplayTag AmmoTags[] = { Ammo0, Ammo1, Ammo2, Ammo3, Ammo4, Ammo5, Ammo6, Ammo7, Ammo8, Ammo9, Ammo10, Ammo11 };
+	static_assert(UE_ARRAY_COUNT(AmmoTags) == UGSAmmoAttributeSet::NumAmmoSlots, "One test ammo type per slot");
+
+	UDataTable* AmmoTypeTable = NewObject<UDataTable>();
+	AmmoTypeTable->RowStruct = FGSAmmoTypeRow::StaticStruct();
+
+	// Rows in reverse slot order, the slot comes from the row and not its position
+	for (int32 Index = UE_ARRAY_COUNT(AmmoTags) - 1; Index >= 0; Index--)
+	{
+		FGSAmmoTypeRow Row;
+		Row.AmmoTag = AmmoTags[Index];
+		Row.Slot = Index;
+		Row.MaxReserveAmmo = 100.0f + Index;
+		Row.StartingReserveAmmo = 10.0f + Index;
+		AmmoTypeTable->AddRow(*FString::Printf(TEXT("Ammo%d"), Index), Row);
+	}
+
+	// A second type in a taken slot is rejected
+	FGSAmmoTypeRow DuplicateSlotRow;
+	DuplicateSlotRow.AmmoTag = VTGameplayTags::Weapon_Ammo_Rifle;
+	DuplicateSlotRow.Slot = 0;
+	AmmoTypeTable->AddRow(TEXT("DuplicateSlot"), DuplicateSlotRow);
+
+	AddExpectedError(TEXT("uses slot 0"), EAutomationExpectedErrorFlags::Contains, 1);
+	UGSAmmoAttributeSet::InitAmmoTypes(AmmoTypeTable);
+	TestEqual(TEXT("Duplicate slot has no slot"), UGSAmmoAttributeSet::GetAmmoSlotForTag(DuplicateSlotRow.AmmoTag), static_cast<int32>(INDEX_NONE));
+
+	{
+		FVTScopedTestWorld TestWorld;
+		const TSubclassOf<UAttributeSet> AttributeSets[] = { UGSAmmoAttributeSet::StaticClass() };
+		UGSAbilitySystemComponent* ASC = TestWorld.SpawnAbilityActor(AttributeSets);
+		const UGSAmmoAttributeSet* AmmoSet = ASC->GetSet<UGSAmmoAttributeSet>();
+
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(AmmoTags); Index++)
+		{
+			FGameplayTag AmmoTag = AmmoTags[Index];
+			TestEqual(TEXT("Slot"), UGSAmmoAttributeSet::GetAmmoSlotForTag(AmmoTag), Index);
+			TestTrue(TEXT("Reserve attribute"), UGSAmmoAttributeSet::GetReserveAmmoAttributeFromTag(AmmoTag) == UGSAmmoAttributeSet::GetReserveAmmoAttributeForSlot(Index));
+			TestEqual(TEXT("Starting reserve from the table"), AmmoSet->GetReserveAmmoForTag(AmmoTag), 10.0f + Index);
+			TestEqual(TEXT("Max reserve from the table"), AmmoSet->GetMaxReserveAmmoForTag(AmmoTag), 100.0f + Index);
+
+			// Spending one type leaves the others alone
+			ASC->ApplyModToAttribute(UGSAmmoAttributeSet::GetReserveAmmoAttributeFromTag(AmmoTag), EGameplayModOp::Additive, -1.0f);
+		}
+
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(AmmoTags); Index++)
+		{
+			TestEqual(TEXT("Reserve after spending"), AmmoSet->GetReserveAmmoForTag(AmmoTags[Index]), 9.0f + Index);
+		}
+
+		const_cast<UGSAmmoAttributeSet*>(AmmoSet)->RefillReserveAmmo();
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(AmmoTags); Index++)
+		{
+			TestEqual(TEXT("Reserve after refill"), AmmoSet->GetReserveAmmoForTag(AmmoTags[Index]), 100.0f + Index);
+		}
+
+		TestEqual(TEXT("Unknown tag has no slot"), UGSAmmoAttributeSet::GetAmmoSlotForTag(FGameplayTag()), static_cast<int32>(INDEX_NONE));
+	}
+
+	// Back to the project's ammo types
+	UGSAmmoAttributeSet::InitAmmoTypes(Cast<UDataTable>(UGSAbilitySystemGlobals::GSGet().AmmoTypeTableName.TryLoad()));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
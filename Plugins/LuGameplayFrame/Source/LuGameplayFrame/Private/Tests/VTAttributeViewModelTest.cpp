@@ -0,0 +1,61 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/AttributeSets/GSAttributeSetBase.h"
+#include "Tests/VTTestWorld.h"
+#include "UI/VTAttributeViewModel.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTAttributeViewModelOnePushPerDamageTest, "LuGameplayFrame.UI.AttributeViewModel.OnePushPerDamageEvent",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTAttributeViewModelOnePushPerDamageTest::RunTest(const FString& Parameters)
+{
+	FVTScopedTestWorld TestWorld;
+	const TSubclassOf<UAttributeSet> AttributeSets[] = { UGSAttributeSetBase::StaticClass() };
+	UGSAbilitySystemComponent* ASC = TestWorld.SpawnAbilityActor(AttributeSets);
+
+	ASC->SetNumericAttributeBase(UGSAttributeSetBase::GetMaxHealthAttribute(), 100.0f);
+	ASC->SetNumericAttributeBase(UGSAttributeSetBase::GetHealthAttribute(), 100.0f);
+	ASC->SetNumericAttributeBase(UGSAttributeSetBase::GetMaxShieldAttribute(), 100.0f);
+	ASC->SetNumericAttributeBase(UGSAttributeSetBase::GetShieldAttribute(), 50.0f);
+
+	UVTAttributeViewModel* ViewModel = NewObject<UVTAttributeViewModel>(ASC->GetOwner());
+	ViewModel->Initialize(ASC);
+	TestWorld.TickTimers();
+
+	// Every push is one UpdateAttributes call per widget, so pushes per damage event is the Blueprint event count
+	const uint32 SerialBefore = ViewModel->GetViewSerial();
+	constexpr int32 NumDamageEvents = 10;
+	float Shield = 50.0f;
+	float Health = 100.0f;
+	for (int32 Index = 0; Index < NumDamageEvents; Index++)
+	{
+		// A hit of 8 that eats into the shield first, then health
+		const float ShieldDamage = FMath::Min(Shield, 8.0f);
+		Shield -= ShieldDamage;
+		Health -= 8.0f - ShieldDamage;
+
+		ASC->SetNumericAttributeBase(UGSAttributeSetBase::GetShieldAttribute(), Shield);
+		ASC->SetNumericAttributeBase(UGSAttributeSetBase::GetHealthAttribute(), Health);
+		TestWorld.TickTimers();
+	}
+
+	TestEqual(TEXT("Pushes per damage event"), static_cast<int32>(ViewModel->GetViewSerial() - SerialBefore), NumDamageEvents);
+	TestEqual(TEXT("Health"), ViewModel->GetView().Health, Health);
+	TestEqual(TEXT("Shield"), ViewModel->GetView().Shield, Shield);
+	TestEqual(TEXT("HealthPercentage"), ViewModel->GetView().HealthPercentage, Health / 100.0f);
+	TestTrue(TEXT("Only health and shield changed"), ViewModel->GetFieldsChangedSince(SerialBefore) == (EVTAttributeViewField::Health | EVTAttributeViewField::Shield));
+
+	// Nothing changed, nothing is pushed
+	const uint32 SerialIdle = ViewModel->GetViewSerial();
+	TestWorld.TickTimers();
+	TestEqual(TEXT("Pushes without changes"), ViewModel->GetViewSerial(), SerialIdle);
+
+	ViewModel->Deinitialize();
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,122 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/VTCharacterBase.h"
+#include "Characters/VTCharacterPoolSubsystem.h"
+#include "EngineUtils.h"
+#include "GameplayEffect.h"
+#include "Tests/VTTestWorld.h"
+#include "UObject/UObjectArray.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTCharacterPoolTenPlayersTest, "LuGameplayFrame.Characters.CharacterPool.TenPlayerRespawn",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTCharacterPoolTenPlayersTest::RunTest(const FString& Parameters)
+{
+	if (!UVTCharacterPoolSubsystem::IsPoolingEnabled())
+	{
+		AddWarning(TEXT("VT.CharacterPool.Enable is off, nothing to test"));
+		return true;
+	}
+
+	FVTScopedTestWorld TestWorld;
+
+	UVTCharacterPoolSubsystem* CharacterPool = TestWorld.World->GetSubsystem<UVTCharacterPoolSubsystem>();
+	if (!TestNotNull(TEXT("Character pool subsystem"), CharacterPool))
+	{
+		return false;
+	}
+
+	constexpr int32 NumPlayers = 10;
+	auto GetSpawnTransform = [](int32 Index) { return FTransform(FVector(Index * 200.0f, 0.0f, 100.0f)); };
+
+	// Round start without a pool: every player gets a freshly spawned character
+	TArray<AVTCharacterBase*> Characters;
+	double SlowestAcquireMs = 0.0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumPlayers; Index++)
+	{
+		const double AcquireStart = FPlatformTime::Seconds();
+		AVTCharacterBase* Character = CharacterPool->AcquireCharacter(AVTCharacterBase::StaticClass(), GetSpawnTransform(Index));
+		SlowestAcquireMs = FMath::Max(SlowestAcquireMs, (FPlatformTime::Seconds() - AcquireStart) * 1000.0);
+
+		// What a character that owns its ASC would have set up
+		UGSAbilitySystemComponent* ASC = NewObject<UGSAbilitySystemComponent>(Character);
+		ASC->RegisterComponent();
+		VTSetTestProperty(Character, TEXT("AbilitySystemComponent"), ASC);
+		VTSetTestProperty(Character, TEXT("DefaultAttributes"), TSubclassOf<UGameplayEffect>(UGameplayEffect::StaticClass()));
+		ASC->InitAbilityActorInfo(Character, Character);
+		Characters.Add(Character);
+	}
+	const double SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	const double SlowestSpawnMs = SlowestAcquireMs;
+
+	// The first death and respawn settles anything created lazily on the first reuse
+	for (AVTCharacterBase* Character : Characters)
+	{
+		Character->Die();
+	}
+	for (int32 Index = 0; Index < NumPlayers; Index++)
+	{
+		CharacterPool->AcquireCharacter(AVTCharacterBase::StaticClass(), GetSpawnTransform(Index));
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const int32 ObjectCountBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	// Everybody dies and respawns, as at the start of every round
+	constexpr int32 NumRounds = 10;
+	TArray<AVTCharacterBase*> Respawned;
+	SlowestAcquireMs = 0.0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < NumRounds; Round++)
+	{
+		for (AVTCharacterBase* Character : Characters)
+		{
+			Character->Die();
+			TestTrue(TEXT("Dead character is pooled, not destroyed"), IsValid(Character) && Character->IsPooled());
+		}
+
+		Respawned.Reset();
+		for (int32 Index = 0; Index < NumPlayers; Index++)
+		{
+			const double AcquireStart = FPlatformTime::Seconds();
+			Respawned.Add(CharacterPool->AcquireCharacter(AVTCharacterBase::StaticClass(), GetSpawnTransform(Index)));
+			SlowestAcquireMs = FMath::Max(SlowestAcquireMs, (FPlatformTime::Seconds() - AcquireStart) * 1000.0);
+		}
+	}
+	const double RespawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumRounds;
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const int32 ObjectCountAfter = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	// Timings are informational only, the assertions are on reuse
+	AddInfo(FString::Printf(TEXT("Respawning %d players: spawned %.3fms (slowest %.3fms), pooled %.3fms per round (slowest %.3fms). Live UObjects %d -> %d"),
+		NumPlayers, SpawnMs, SlowestSpawnMs, RespawnMs, SlowestAcquireMs, ObjectCountBefore, ObjectCountAfter));
+	TestTrue(TEXT("No UObjects left behind by respawns"), ObjectCountAfter <= ObjectCountBefore);
+
+	int32 NumCharacterActors = 0;
+	for (TActorIterator<AVTCharacterBase> It(TestWorld.World); It; ++It)
+	{
+		++NumCharacterActors;
+	}
+	TestEqual(TEXT("No characters spawned by respawns"), NumCharacterActors, NumPlayers);
+
+	for (int32 Index = 0; Index < NumPlayers; Index++)
+	{
+		AVTCharacterBase* Character = Respawned[Index];
+		TestTrue(TEXT("Respawn reuses a pooled character"), Characters.Contains(Character));
+		if (Character)
+		{
+			TestFalse(TEXT("Respawned character is active"), Character->IsPooled() || Character->IsHidden());
+			TestTrue(TEXT("Respawned at the spawn point"), Character->GetActorLocation().Equals(GetSpawnTransform(Index).GetLocation()));
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
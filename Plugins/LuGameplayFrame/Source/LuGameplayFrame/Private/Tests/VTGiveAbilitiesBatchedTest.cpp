@@ -0,0 +1,91 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/GSGameplayAbility.h"
+#include "Tests/VTTestWorld.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTGiveAbilitiesBatchedTest, "LuGameplayFrame.Abilities.GiveAbilitiesBatched",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTGiveAbilitiesBatchedTest::RunTest(const FString& Parameters)
+{
+	FVTScopedTestWorld TestWorld;
+
+	constexpr int32 NumCharacters = 64;
+	constexpr int32 NumAbilities = 20;
+
+	TArray<FGameplayAbilitySpec> Specs;
+	for (int32 Index = 0; Index < NumAbilities; Index++)
+	{
+		Specs.Emplace(UGSGameplayAbility::StaticClass(), 1, INDEX_NONE);
+	}
+
+	TArray<UGSAbilitySystemComponent*> BatchedASCs;
+	TArray<UGSAbilitySystemComponent*> SingleASCs;
+	for (int32 Index = 0; Index < NumCharacters; Index++)
+	{
+		BatchedASCs.Add(TestWorld.SpawnAbilityActor());
+		SingleASCs.Add(TestWorld.SpawnAbilityActor());
+	}
+
+	int32 NumDirtiedCallbacks = 0;
+	for (UGSAbilitySystemComponent* ASC : BatchedASCs)
+	{
+		ASC->AbilitySpecDirtiedCallbacks.AddLambda([&NumDirtiedCallbacks](const FGameplayAbilitySpec&) { NumDirtiedCallbacks++; });
+	}
+
+	// One GiveAbility per spec is the baseline
+	double StartTime = FPlatformTime::Seconds();
+	for (UGSAbilitySystemComponent* ASC : SingleASCs)
+	{
+		for (const FGameplayAbilitySpec& Spec : Specs)
+		{
+			ASC->GiveAbility(Spec);
+		}
+	}
+	const double SingleMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	TArray<TArray<FGameplayAbilitySpecHandle>> BatchedHandles;
+	BatchedHandles.SetNum(NumCharacters);
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumCharacters; Index++)
+	{
+		BatchedASCs[Index]->GiveAbilitiesBatched(Specs, BatchedHandles[Index]);
+	}
+	const double BatchedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Timings are informational only, machines running the tests vary too much to assert on them
+	AddInfo(FString::Printf(TEXT("%d abilities x %d characters: GiveAbility %.3fms, GiveAbilitiesBatched %.3fms"), NumAbilities, NumCharacters, SingleMs, BatchedMs));
+
+	// Same result as one GiveAbility per spec, with the handles in spec order
+	for (int32 Index = 0; Index < NumCharacters; Index++)
+	{
+		const TArray<FGameplayAbilitySpec>& Granted = BatchedASCs[Index]->GetActivatableAbilities();
+		TestEqual(TEXT("Same count as GiveAbility"), Granted.Num(), SingleASCs[Index]->GetActivatableAbilities().Num());
+		if (TestEqual(TEXT("One handle per spec"), BatchedHandles[Index].Num(), Granted.Num()))
+		{
+			for (int32 SpecIndex = 0; SpecIndex < Granted.Num(); SpecIndex++)
+			{
+				TestTrue(TEXT("Handles in spec order"), BatchedHandles[Index][SpecIndex] == Granted[SpecIndex].Handle);
+			}
+		}
+	}
+
+	// Replicates like GiveAbility: every new item has a replication ID and was announced once
+	TestEqual(TEXT("Dirtied callbacks"), NumDirtiedCallbacks, NumCharacters * NumAbilities);
+	for (UGSAbilitySystemComponent* ASC : BatchedASCs)
+	{
+		TestEqual(TEXT("Abilities granted"), ASC->GetActivatableAbilities().Num(), NumAbilities);
+		for (const FGameplayAbilitySpec& Spec : ASC->GetActivatableAbilities())
+		{
+			TestTrue(TEXT("Spec marked dirty"), Spec.ReplicationID != INDEX_NONE);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
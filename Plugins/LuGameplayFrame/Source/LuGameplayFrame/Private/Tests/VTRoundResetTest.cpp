@@ -0,0 +1,95 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/AttributeSets/GSAmmoAttributeSet.h"
+#include "Characters/Abilities/VTAbilitySet.h"
+#include "Characters/VTCharacterBase.h"
+#include "Game/VTRoundResetSubsystem.h"
+#include "GameplayEffect.h"
+#include "Tests/VTTestWorld.h"
+#include "UObject/UObjectArray.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTRoundResetTenPlayersTest, "LuGameplayFrame.Game.RoundReset.TenPlayers",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTRoundResetTenPlayersTest::RunTest(const FString& Parameters)
+{
+	FVTScopedTestWorld TestWorld;
+
+	UVTRoundResetSubsystem* RoundReset = TestWorld.World->GetSubsystem<UVTRoundResetSubsystem>();
+	if (!TestNotNull(TEXT("Round reset subsystem"), RoundReset))
+	{
+		return false;
+	}
+
+	// Loadout that grants an attribute set, which round resets must not create again
+	UVTAbilitySet* AbilitySet = NewObject<UVTAbilitySet>(TestWorld.World);
+	FVTAbilitySet_AttributeSet AmmoSet;
+	AmmoSet.AttributeSet = UGSAmmoAttributeSet::StaticClass();
+	VTSetTestProperty(AbilitySet, TEXT("GrantedAttributes"), TArray<FVTAbilitySet_AttributeSet>{ AmmoSet });
+
+	constexpr int32 NumPlayers = 10;
+	TArray<UGSAbilitySystemComponent*> ASCs;
+	for (int32 Index = 0; Index < NumPlayers; Index++)
+	{
+		AVTCharacterBase* Character = TestWorld.World->SpawnActor<AVTCharacterBase>();
+		UGSAbilitySystemComponent* ASC = NewObject<UGSAbilitySystemComponent>(Character);
+		ASC->RegisterComponent();
+
+		// What a Blueprint character that owns its ASC would have set up
+		VTSetTestProperty(Character, TEXT("AbilitySystemComponent"), ASC);
+		VTSetTestProperty(Character, TEXT("AbilitySets"), TArray<UVTAbilitySet*>{ AbilitySet });
+		VTSetTestProperty(Character, TEXT("DefaultAttributes"), TSubclassOf<UGameplayEffect>(UGameplayEffect::StaticClass()));
+		ASC->InitAbilityActorInfo(Character, Character);
+		ASCs.Add(ASC);
+	}
+
+	// The first reset grants the loadout, the second is the first that reuses it
+	RoundReset->ResetRound();
+	RoundReset->ResetRound();
+
+	// Spend some of the round so the resets have something to undo
+	const FGameplayAttribute MaxAmmoAttribute = UGSAmmoAttributeSet::GetMaxReserveAmmoAttributeForSlot(0);
+	TArray<const UGSAmmoAttributeSet*> AmmoSets;
+	TArray<float> StartingMaxAmmo;
+	TArray<int32> NumAbilities;
+	for (UGSAbilitySystemComponent* ASC : ASCs)
+	{
+		AmmoSets.Add(ASC->GetSet<UGSAmmoAttributeSet>());
+		NumAbilities.Add(ASC->GetActivatableAbilities().Num());
+		StartingMaxAmmo.Add(ASC->GetNumericAttributeBase(MaxAmmoAttribute));
+		ASC->SetNumericAttributeBase(MaxAmmoAttribute, 999.0f);
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const int32 ObjectCountBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	constexpr int32 NumResets = 20;
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 Reset = 0; Reset < NumResets; Reset++)
+	{
+		RoundReset->ResetRound();
+	}
+	const double AverageMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / NumResets;
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	const int32 ObjectCountAfter = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+	// The timing is informational only, the assertions are on reuse
+	AddInfo(FString::Printf(TEXT("Round reset for %d players: %.3fms. Live UObjects %d -> %d"), NumPlayers, AverageMs, ObjectCountBefore, ObjectCountAfter));
+	TestTrue(TEXT("No UObjects left behind by round resets"), ObjectCountAfter <= ObjectCountBefore);
+
+	for (int32 Index = 0; Index < NumPlayers; Index++)
+	{
+		TestTrue(TEXT("Attribute set is reused"), ASCs[Index]->GetSet<UGSAmmoAttributeSet>() == AmmoSets[Index]);
+		TestEqual(TEXT("Loadout not granted again"), ASCs[Index]->GetActivatableAbilities().Num(), NumAbilities[Index]);
+		TestEqual(TEXT("Reused attribute set is back at its starting values"), ASCs[Index]->GetNumericAttributeBase(MaxAmmoAttribute), StartingMaxAmmo[Index]);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
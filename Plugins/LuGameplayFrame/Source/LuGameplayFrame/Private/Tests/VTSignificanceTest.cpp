@@ -0,0 +1,96 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/VTCharacterBase.h"
+#include "Characters/VTSignificanceSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "SignificanceManager.h"
+#include "Tests/VTTestWorld.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTSignificanceSixtyFourBotsTest, "LuGameplayFrame.Characters.Significance.SixtyFourBots",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTSignificanceSixtyFourBotsTest::RunTest(const FString& Parameters)
+{
+	FVTScopedTestWorld TestWorld;
+
+	USignificanceManager* SignificanceManager = FSignificanceManagerModule::Get(TestWorld.World);
+	if (!TestNotNull(TEXT("Significance manager"), SignificanceManager) || !TestNotNull(TEXT("Significance subsystem"), TestWorld.World->GetSubsystem<UVTSignificanceSubsystem>()))
+	{
+		return false;
+	}
+
+	// Pairs of bots at the same distance, one in front of the viewpoint and one behind, from point blank to past MaxDistance
+	constexpr int32 NumBots = 64;
+	TArray<AVTCharacterBase*> Bots;
+	for (int32 Index = 0; Index < NumBots; Index++)
+	{
+		const float Distance = 500.0f + (Index / 2) * 400.0f;
+		const FVector Location((Index % 2 == 0 ? 1.0f : -1.0f) * Distance, (Index / 2) * 10.0f, 100.0f);
+		AVTCharacterBase* Bot = TestWorld.World->SpawnActor<AVTCharacterBase>(Location, FRotator::ZeroRotator);
+		if (!TestNotNull(TEXT("Bot spawned"), Bot))
+		{
+			return false;
+		}
+
+		// Remote characters on a client, the ones ranking throttles
+		Bot->SetRole(ROLE_SimulatedProxy);
+		Bots.Add(Bot);
+	}
+
+	// One far bot behind the viewpoint is fighting
+	AVTCharacterBase* FightingBot = Bots.Last();
+	FightingBot->NotifyCombatActivity();
+
+	const FTransform Viewpoints[] = { FTransform(FRotator::ZeroRotator, FVector(0.0f, 0.0f, 100.0f)) };
+	const double StartTime = FPlatformTime::Seconds();
+	SignificanceManager->Update(Viewpoints);
+	const double UpdateMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Mesh ticks per second at 60fps, every bot at full rate before ranking
+	constexpr float FrameRate = 60.0f;
+	float MeshTicksPerSecond = 0.0f;
+	int32 NumPerTier[4] = {};
+	for (const AVTCharacterBase* Bot : Bots)
+	{
+		const float TickInterval = Bot->GetMesh()->GetComponentTickInterval();
+		MeshTicksPerSecond += TickInterval > 0.0f ? FMath::Min(FrameRate, 1.0f / TickInterval) : FrameRate;
+		NumPerTier[static_cast<int32>(Bot->GetSignificanceTier())]++;
+	}
+
+	// Timings are informational only, the assertions are on the ranking and the rates it applies
+	AddInfo(FString::Printf(TEXT("%d bots: significance update %.3fms. Mesh ticks/s %.0f -> %.0f. High %d, Medium %d, Low %d, Off %d"),
+		NumBots, UpdateMs, NumBots * FrameRate, MeshTicksPerSecond, NumPerTier[0], NumPerTier[1], NumPerTier[2], NumPerTier[3]));
+
+	TestEqual(TEXT("Point blank bot is High"), Bots[0]->GetSignificanceTier(), EVTSignificanceTier::High);
+	TestEqual(TEXT("Bot past MaxDistance is Off"), Bots[NumBots - 2]->GetSignificanceTier(), EVTSignificanceTier::Off);
+	TestTrue(TEXT("Fighting bot stays at least Medium"), FightingBot->GetSignificanceTier() <= EVTSignificanceTier::Medium);
+	TestTrue(TEXT("Ranking reduces mesh ticks"), MeshTicksPerSecond < NumBots * FrameRate);
+
+	for (int32 Index = 0; Index + 1 < NumBots - 1; Index += 2)
+	{
+		TestTrue(TEXT("Bot in front is at least as significant as the one behind"), Bots[Index]->GetSignificanceTier() <= Bots[Index + 1]->GetSignificanceTier());
+		TestTrue(TEXT("Further bots are never more significant"), Bots[Index]->GetSignificanceTier() <= Bots[Index + 2]->GetSignificanceTier());
+	}
+
+	for (const AVTCharacterBase* Bot : Bots)
+	{
+		const float TickInterval = Bot->GetMesh()->GetComponentTickInterval();
+		if (Bot->GetSignificanceTier() == EVTSignificanceTier::High)
+		{
+			TestEqual(TEXT("High bots animate every frame"), TickInterval, 0.0f);
+			TestEqual(TEXT("High bots keep their smoothing"), Bot->GetCharacterMovement()->NetworkSmoothingMode, Bots[0]->GetCharacterMovement()->NetworkSmoothingMode);
+		}
+		else
+		{
+			TestTrue(TEXT("Less significant bots animate less often"), TickInterval > 0.0f);
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,98 @@
+// Copyright 2024 Dan Kestranek.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Characters/Abilities/GSGameplayAbility.h"
+#include "Characters/Abilities/GSTargetType.h"
+#include "GameplayEffect.h"
+#include "Tests/VTTestWorld.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVTTargetTypeTest, "LuGameplayFrame.Abilities.TargetType.CollectTargets",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FVTTargetTypeTest::RunTest(const FString& Parameters)
+{
+	FVTScopedTestWorld TestWorld;
+	UGSAbilitySystemComponent* ASC = TestWorld.SpawnAbilityActor();
+	const FGameplayAbilitySpecHandle Handle = ASC->GiveAbility(FGameplayAbilitySpec(UGSGameplayAbility::StaticClass()));
+	UGSGameplayAbility* Ability = Cast<UGSGameplayAbility>(ASC->FindAbilitySpecFromHandle(Handle)->GetPrimaryInstance());
+	if (!TestNotNull(TEXT("Ability instance"), Ability))
+	{
+		return false;
+	}
+
+	// A shotgun blast: one hit per pellet in the event's target data
+	constexpr int32 NumPellets = 12;
+	FGameplayEventData EventData;
+	for (int32 Pellet = 0; Pellet < NumPellets; Pellet++)
+	{
+		FHitResult HitResult;
+		HitResult.Location = FVector(100.0f, Pellet, 0.0f);
+		EventData.TargetData.Add(new FGameplayAbilityTargetData_SingleTargetHit(HitResult));
+	}
+
+	FGSGameplayEffectContainer Container;
+	Container.TargetType = UGSTargetType_UseEventTargetData::StaticClass();
+	Container.TargetGameplayEffectClasses.Add(UGameplayEffect::StaticClass());
+
+	const UGSTargetType* TargetTypeCDO = Container.TargetType.GetDefaultObject();
+	constexpr int32 NumBlasts = 2000;
+
+	// What MakeEffectContainerSpecFromContainer did before: heap arrays filled through the Blueprint event thunk
+	int32 NumEventTargets = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumBlasts; Index++)
+	{
+		TArray<FGameplayAbilityTargetDataHandle> TargetData;
+		TArray<FHitResult> HitResults;
+		TArray<AActor*> Actors;
+		TargetTypeCDO->GetTargets(nullptr, nullptr, EventData, TargetData, HitResults, Actors);
+
+		FGSGameplayEffectContainerSpec Spec;
+		Spec.AddTargets(TargetData, HitResults, Actors);
+		for (const TSubclassOf<UGameplayEffect>& EffectClass : Container.TargetGameplayEffectClasses)
+		{
+			Spec.TargetGameplayEffectSpecs.Add(Ability->MakeOutgoingGameplayEffectSpec(EffectClass, 1.0f));
+		}
+		NumEventTargets += Spec.TargetData.Num();
+	}
+	const double EventMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	int32 NumContainerTargets = 0;
+	int32 NumContainerSpecs = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumBlasts; Index++)
+	{
+		const FGSGameplayEffectContainerSpec Spec = Ability->MakeEffectContainerSpecFromContainer(Container, EventData);
+		NumContainerTargets += Spec.TargetData.Num();
+		NumContainerSpecs += Spec.TargetGameplayEffectSpecs.Num();
+	}
+	const double ContainerMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	// Timings are informational only, the assertions are on the targets and the buffers
+	AddInfo(FString::Printf(TEXT("%d container specs of %d pellets: GetTargets %.3fms, MakeEffectContainerSpecFromContainer %.3fms"), NumBlasts, NumPellets, EventMs, ContainerMs));
+	TestEqual(TEXT("Both paths find the same targets"), NumContainerTargets, NumEventTargets);
+	TestEqual(TEXT("One target per pellet"), NumContainerTargets, NumBlasts * NumPellets);
+	TestEqual(TEXT("One effect spec per blast"), NumContainerSpecs, NumBlasts);
+
+	// A full blast stays in the inline storage, so native targeting doesn't allocate
+	FGSTargetBuffers Targets;
+	TargetTypeCDO->CollectTargets(nullptr, nullptr, EventData, Targets);
+	const uint8* HitData = reinterpret_cast<const uint8*>(Targets.HitResults.GetData());
+	TestEqual(TEXT("Every pellet collected"), Targets.HitResults.Num(), NumPellets);
+	TestTrue(TEXT("Pellet hits in the inline buffer"), HitData >= reinterpret_cast<const uint8*>(&Targets) && HitData < reinterpret_cast<const uint8*>(&Targets + 1));
+
+	// Single target events still go through UseEventData
+	AActor* TargetActor = TestWorld.World->SpawnActor<AActor>();
+	FGameplayEventData ActorEventData;
+	ActorEventData.Target = TargetActor;
+	Targets.Reset();
+	GetDefault<UGSTargetType_UseEventData>()->CollectTargets(nullptr, nullptr, ActorEventData, Targets);
+	TestTrue(TEXT("Event target collected"), Targets.Actors.Num() == 1 && Targets.Actors[0] == TargetActor);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,74 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "CoreMinimal.h"
+#include "AttributeSet.h"
+#include "Characters/Abilities/GSAbilitySystemComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UnrealType.h"
+
+// Sets a reflected property that has no public setter, e.g. Blueprint-only defaults of a native class
+template<typename ValueType>
+void VTSetTestProperty(UObject* Object, FName PropertyName, const ValueType& Value)
+{
+	FProperty* Property = FindFProperty<FProperty>(Object->GetClass(), PropertyName);
+	check(Property && Property->GetElementSize() == sizeof(ValueType));
+	*Property->ContainerPtrToValuePtr<ValueType>(Object) = Value;
+}
+
+/**
+ * Game world for automation tests. Everything spawned in it goes away with it.
+ */
+struct FVTScopedTestWorld
+{
+	UWorld* World = nullptr;
+
+	FVTScopedTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("VTTestWorld"));
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+	}
+
+	~FVTScopedTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	// Actor that owns and avatars a registered UGSAbilitySystemComponent with the given attribute sets
+	UGSAbilitySystemComponent* SpawnAbilityActor(TArrayView<const TSubclassOf<UAttributeSet>> AttributeSetClasses = {})
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		UGSAbilitySystemComponent* ASC = NewObject<UGSAbilitySystemComponent>(Actor);
+		ASC->RegisterComponent();
+
+		for (const TSubclassOf<UAttributeSet>& AttributeSetClass : AttributeSetClasses)
+		{
+			ASC->AddAttributeSetSubobject(NewObject<UAttributeSet>(Actor, AttributeSetClass));
+		}
+
+		ASC->InitAbilityActorInfo(Actor, Actor);
+		return ASC;
+	}
+
+	// Starts a new frame and runs the timers that are due, including SetTimerForNextTick ones
+	void TickTimers(float DeltaSeconds = 1.0f / 60.0f)
+	{
+		++GFrameCounter;
+		World->GetTimerManager().Tick(DeltaSeconds);
+	}
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,226 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "UI/VTAttributeViewModel.h"
+#include "AbilitySystemComponent.h"
+#include "Characters/Abilities/AttributeSets/GSAttributeSetBase.h"
+#include "Engine/World.h"
+#include "LuGameplayFrame.h"
+#include "TimerManager.h"
+#include "UI/VTFloatingStatusBarSubsystem.h"
+#include "UI/VTHUDWidget.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attribute View Changes"), STAT_VTAttributeViewChanges, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Attribute View Widget Updates"), STAT_VTAttributeViewWidgetUpdates, STATGROUP_LuGameplayFrame);
+
+namespace VTAttributeView
+{
+	struct FBinding
+	{
+		FGameplayAttribute (*GetAttribute)();
+		EVTAttributeViewField Field;
+		float FVTAttributeView::* FloatMember;
+		int32 FVTAttributeView::* IntMember;
+	};
+
+	static const FBinding Bindings[] =
+	{
+		{ &UGSAttributeSetBase::GetHealthAttribute,				EVTAttributeViewField::Health,			&FVTAttributeView::Health,				nullptr },
+		{ &UGSAttributeSetBase::GetMaxHealthAttribute,			EVTAttributeViewField::Health,			&FVTAttributeView::MaxHealth,			nullptr },
+		{ &UGSAttributeSetBase::GetHealthRegenRateAttribute,	EVTAttributeViewField::RegenRates,		&FVTAttributeView::HealthRegenRate,		nullptr },
+		{ &UGSAttributeSetBase::GetManaAttribute,				EVTAttributeViewField::Mana,			&FVTAttributeView::Mana,				nullptr },
+		{ &UGSAttributeSetBase::GetMaxManaAttribute,			EVTAttributeViewField::Mana,			&FVTAttributeView::MaxMana,				nullptr },
+		{ &UGSAttributeSetBase::GetManaRegenRateAttribute,		EVTAttributeViewField::RegenRates,		&FVTAttributeView::ManaRegenRate,		nullptr },
+		{ &UGSAttributeSetBase::GetStaminaAttribute,			EVTAttributeViewField::Stamina,			&FVTAttributeView::Stamina,				nullptr },
+		{ &UGSAttributeSetBase::GetMaxStaminaAttribute,			EVTAttributeViewField::Stamina,			&FVTAttributeView::MaxStamina,			nullptr },
+		{ &UGSAttributeSetBase::GetStaminaRegenRateAttribute,	EVTAttributeViewField::RegenRates,		&FVTAttributeView::StaminaRegenRate,	nullptr },
+		{ &UGSAttributeSetBase::GetShieldAttribute,				EVTAttributeViewField::Shield,			&FVTAttributeView::Shield,				nullptr },
+		{ &UGSAttributeSetBase::GetMaxShieldAttribute,			EVTAttributeViewField::Shield,			&FVTAttributeView::MaxShield,			nullptr },
+		{ &UGSAttributeSetBase::GetShieldRegenRateAttribute,	EVTAttributeViewField::RegenRates,		&FVTAttributeView::ShieldRegenRate,		nullptr },
+		{ &UGSAttributeSetBase::GetXPAttribute,					EVTAttributeViewField::Experience,		nullptr,								&FVTAttributeView::Experience },
+		{ &UGSAttributeSetBase::GetGoldAttribute,				EVTAttributeViewField::Gold,			nullptr,								&FVTAttributeView::Gold },
+		{ &UGSAttributeSetBase::GetCharacterLevelAttribute,		EVTAttributeViewField::CharacterLevel,	nullptr,								&FVTAttributeView::CharacterLevel },
+	};
+
+	static void SetValue(FVTAttributeView& View, const FBinding& Binding, float Value)
+	{
+		if (Binding.FloatMember)
+		{
+			View.*Binding.FloatMember = Value;
+		}
+		else
+		{
+			View.*Binding.IntMember = FMath::FloorToInt(Value);
+		}
+	}
+
+	static float GetPercentage(float Current, float Max)
+	{
+		return Max > 0.0f ? FMath::Clamp(Current / Max, 0.0f, 1.0f) : 0.0f;
+	}
+}
+
+void UVTAttributeViewModel::Initialize(UAbilitySystemComponent* InAbilitySystemComponent)
+{
+	Deinitialize();
+
+	AbilitySystemComponent = InAbilitySystemComponent;
+	if (!IsValid(AbilitySystemComponent))
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(VTAttributeView::Bindings); Index++)
+	{
+		const VTAttributeView::FBinding& Binding = VTAttributeView::Bindings[Index];
+		const FGameplayAttribute Attribute = Binding.GetAttribute();
+
+		VTAttributeView::SetValue(View, Binding, AbilitySystemComponent->GetNumericAttribute(Attribute));
+
+		FDelegateHandle Handle = AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(Attribute).AddUObject(this, &UVTAttributeViewModel::OnAttributeChanged, Index);
+		AttributeChangedHandles.Emplace(Attribute, Handle);
+	}
+
+	UpdatePercentages(View, EVTAttributeViewField::Health | EVTAttributeViewField::Mana | EVTAttributeViewField::Stamina | EVTAttributeViewField::Shield);
+
+	// Everything is new to whoever is listening
+	MarkDirty(static_cast<EVTAttributeViewField>(0xFF));
+}
+
+void UVTAttributeViewModel::Deinitialize()
+{
+	if (IsValid(AbilitySystemComponent))
+	{
+		for (const TPair<FGameplayAttribute, FDelegateHandle>& AttributeHandle : AttributeChangedHandles)
+		{
+			AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AttributeHandle.Key).Remove(AttributeHandle.Value);
+		}
+	}
+
+	AttributeChangedHandles.Reset();
+	AbilitySystemComponent = nullptr;
+	DirtyFields = EVTAttributeViewField::None;
+}
+
+void UVTAttributeViewModel::SetHUDWidget(UVTHUDWidget* InHUDWidget)
+{
+	HUDWidget = InHUDWidget;
+
+	if (HUDWidget)
+	{
+		HUDWidget->UpdateAttributes(View, static_cast<int32>(0xFF));
+	}
+}
+
+void UVTAttributeViewModel::AddFloatingStatusBar(UVTFloatingStatusBarWidget* StatusBar)
+{
+	UWorld* World = GetWorld();
+	UVTFloatingStatusBarSubsystem* StatusBarSubsystem = World ? World->GetSubsystem<UVTFloatingStatusBarSubsystem>() : nullptr;
+	if (StatusBar && StatusBarSubsystem)
+	{
+		StatusBarSubsystem->RegisterStatusBar(StatusBar, this);
+	}
+}
+
+void UVTAttributeViewModel::RemoveFloatingStatusBar(UVTFloatingStatusBarWidget* StatusBar)
+{
+	UWorld* World = GetWorld();
+	UVTFloatingStatusBarSubsystem* StatusBarSubsystem = World ? World->GetSubsystem<UVTFloatingStatusBarSubsystem>() : nullptr;
+	if (StatusBar && StatusBarSubsystem)
+	{
+		StatusBarSubsystem->UnregisterStatusBar(StatusBar);
+	}
+}
+
+EVTAttributeViewField UVTAttributeViewModel::GetFieldsChangedSince(uint32 Serial) const
+{
+	EVTAttributeViewField Fields = EVTAttributeViewField::None;
+	for (int32 Bit = 0; Bit < UE_ARRAY_COUNT(FieldSerials); Bit++)
+	{
+		if (FieldSerials[Bit] > Serial)
+		{
+			Fields |= static_cast<EVTAttributeViewField>(1 << Bit);
+		}
+	}
+
+	return Fields;
+}
+
+UWorld* UVTAttributeViewModel::GetWorld() const
+{
+	// Outer is the character
+	UObject* Outer = GetOuter();
+	return Outer && !HasAnyFlags(RF_ClassDefaultObject) ? Outer->GetWorld() : nullptr;
+}
+
+void UVTAttributeViewModel::OnAttributeChanged(const FOnAttributeChangeData& Data, int32 BindingIndex)
+{
+	INC_DWORD_STAT(STAT_VTAttributeViewChanges);
+
+	const VTAttributeView::FBinding& Binding = VTAttributeView::Bindings[BindingIndex];
+	VTAttributeView::SetValue(View, Binding, Data.NewValue);
+	MarkDirty(Binding.Field);
+}
+
+void UVTAttributeViewModel::MarkDirty(EVTAttributeViewField Fields)
+{
+	const bool bWasClean = DirtyFields == EVTAttributeViewField::None;
+	DirtyFields |= Fields;
+
+	UWorld* World = GetWorld();
+	if (bWasClean && World)
+	{
+		World->GetTimerManager().SetTimerForNextTick(this, &UVTAttributeViewModel::Flush);
+	}
+}
+
+void UVTAttributeViewModel::Flush()
+{
+	if (DirtyFields == EVTAttributeViewField::None)
+	{
+		return;
+	}
+
+	const EVTAttributeViewField Fields = DirtyFields;
+	DirtyFields = EVTAttributeViewField::None;
+
+	UpdatePercentages(View, Fields);
+
+	if (HUDWidget)
+	{
+		INC_DWORD_STAT(STAT_VTAttributeViewWidgetUpdates);
+		HUDWidget->UpdateAttributes(View, static_cast<int32>(Fields));
+	}
+
+	++ViewSerial;
+	for (int32 Bit = 0; Bit < UE_ARRAY_COUNT(FieldSerials); Bit++)
+	{
+		if (EnumHasAnyFlags(Fields, static_cast<EVTAttributeViewField>(1 << Bit)))
+		{
+			FieldSerials[Bit] = ViewSerial;
+		}
+	}
+}
+
+void UVTAttributeViewModel::UpdatePercentages(FVTAttributeView& InView, EVTAttributeViewField Fields)
+{
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Health))
+	{
+		InView.HealthPercentage = VTAttributeView::GetPercentage(InView.Health, InView.MaxHealth);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Mana))
+	{
+		InView.ManaPercentage = VTAttributeView::GetPercentage(InView.Mana, InView.MaxMana);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Stamina))
+	{
+		InView.StaminaPercentage = VTAttributeView::GetPercentage(InView.Stamina, InView.MaxStamina);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Shield))
+	{
+		InView.ShieldPercentage = VTAttributeView::GetPercentage(InView.Shield, InView.MaxShield);
+	}
+}
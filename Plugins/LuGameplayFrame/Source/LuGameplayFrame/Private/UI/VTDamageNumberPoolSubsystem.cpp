@@ -0,0 +1,184 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "UI/VTDamageNumberPoolSubsystem.h"
+#include "Characters/VTCharacterBase.h"
+#include "Engine/AssetManager.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "LuGameplayFrame.h"
+#include "UI/VTDamageTextWidgetComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Shown"), STAT_VTDamageNumbersShown, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Numbers Created"), STAT_VTDamageNumbersCreated, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Damage Numbers Pooled"), STAT_VTDamageNumbersPooled, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<float> CVarDamageNumberMergeWindow(
+	TEXT("VT.DamageNumbers.MergeWindow"),
+	0.2f,
+	TEXT("Seconds in which hits on the same target with the same tags are added into one damage number. 0 disables merging.")
+);
+
+static TAutoConsoleVariable<int32> CVarDamageNumberMaxPooled(
+	TEXT("VT.DamageNumbers.MaxPooled"),
+	32,
+	TEXT("Free damage number components kept around for reuse")
+);
+
+bool UVTDamageNumberPoolSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_SERVER
+	return false;
+#else
+	if (!Super::ShouldCreateSubsystem(Outer) || IsRunningDedicatedServer())
+	{
+		return false;
+	}
+
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+#endif
+}
+
+void UVTDamageNumberPoolSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Blueprint characters usually keep the default, so get it going while the map loads
+	PreloadDamageNumberClass(GetDefault<AVTCharacterBase>()->GetDamageNumberClass());
+}
+
+void UVTDamageNumberPoolSubsystem::Deinitialize()
+{
+	for (TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& Handle : DamageNumberClassHandles)
+	{
+		if (Handle.Value.IsValid())
+		{
+			Handle.Value->ReleaseHandle();
+		}
+	}
+	DamageNumberClassHandles.Reset();
+
+	FreeDamageTexts.Reset();
+	PoolOwner = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UVTDamageNumberPoolSubsystem::PreloadDamageNumberClass(const TSoftClassPtr<UVTDamageTextWidgetComponent>& DamageNumberClass)
+{
+	const FSoftObjectPath& Path = DamageNumberClass.ToSoftObjectPath();
+	if (Path.IsNull() || DamageNumberClassHandles.Contains(Path))
+	{
+		return;
+	}
+
+	DamageNumberClassHandles.Add(Path, UAssetManager::GetStreamableManager().RequestAsyncLoad(Path));
+}
+
+UVTDamageTextWidgetComponent* UVTDamageNumberPoolSubsystem::ShowDamageNumber(AActor* Target, const TSoftClassPtr<UVTDamageTextWidgetComponent>& SoftDamageNumberClass, float Damage, const FGameplayTagContainer& Tags)
+{
+	if (!IsValid(Target) || !Target->GetRootComponent())
+	{
+		return nullptr;
+	}
+
+	TSubclassOf<UVTDamageTextWidgetComponent> DamageNumberClass = SoftDamageNumberClass.Get();
+	if (!DamageNumberClass)
+	{
+		// Not worth a hitch. Numbers show up once it's in.
+		PreloadDamageNumberClass(SoftDamageNumberClass);
+		return nullptr;
+	}
+
+	UVTDamageTextWidgetComponent* DamageText = Acquire(DamageNumberClass);
+	if (!DamageText)
+	{
+		return nullptr;
+	}
+
+	// Same placement as a freshly created component
+	DamageText->SetRelativeTransform(DamageNumberClass.GetDefaultObject()->GetRelativeTransform());
+	DamageText->AttachToComponent(Target->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	DamageText->SetVisibility(true);
+	DamageText->SetComponentTickEnabled(true);
+	DamageText->SetInUse(true);
+	DamageText->ShowDamage(Damage, Tags);
+
+	INC_DWORD_STAT(STAT_VTDamageNumbersShown);
+
+	return DamageText;
+}
+
+void UVTDamageNumberPoolSubsystem::Release(UVTDamageTextWidgetComponent* DamageText)
+{
+	if (!IsValid(DamageText))
+	{
+		return;
+	}
+
+	DamageText->SetInUse(false);
+
+	if (FreeDamageTexts.Num() >= CVarDamageNumberMaxPooled.GetValueOnGameThread())
+	{
+		DamageText->DestroyComponent();
+		return;
+	}
+
+	DamageText->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	DamageText->SetVisibility(false);
+	DamageText->SetComponentTickEnabled(false);
+
+	FreeDamageTexts.Add(DamageText);
+	INC_DWORD_STAT(STAT_VTDamageNumbersPooled);
+}
+
+float UVTDamageNumberPoolSubsystem::GetMergeWindow()
+{
+	return CVarDamageNumberMergeWindow.GetValueOnGameThread();
+}
+
+UVTDamageTextWidgetComponent* UVTDamageNumberPoolSubsystem::Acquire(TSubclassOf<UVTDamageTextWidgetComponent> DamageNumberClass)
+{
+	// Normally there is only one damage number class so this finds a match at the back
+	for (int32 Index = FreeDamageTexts.Num() - 1; Index >= 0; --Index)
+	{
+		UVTDamageTextWidgetComponent* DamageText = FreeDamageTexts[Index];
+		if (!IsValid(DamageText))
+		{
+			FreeDamageTexts.RemoveAtSwap(Index);
+			DEC_DWORD_STAT(STAT_VTDamageNumbersPooled);
+			continue;
+		}
+
+		if (DamageText->GetClass() == DamageNumberClass)
+		{
+			FreeDamageTexts.RemoveAtSwap(Index);
+			DEC_DWORD_STAT(STAT_VTDamageNumbersPooled);
+			return DamageText;
+		}
+	}
+
+	if (!IsValid(PoolOwner))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("DamageNumberPool");
+		SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		PoolOwner = GetWorld()->SpawnActor<AActor>(SpawnParams);
+		if (!PoolOwner)
+		{
+			return nullptr;
+		}
+
+		PoolOwner->SetRootComponent(NewObject<USceneComponent>(PoolOwner, TEXT("Root")));
+		PoolOwner->GetRootComponent()->RegisterComponent();
+	}
+
+	UVTDamageTextWidgetComponent* DamageText = NewObject<UVTDamageTextWidgetComponent>(PoolOwner, DamageNumberClass);
+	DamageText->RegisterComponent();
+
+	INC_DWORD_STAT(STAT_VTDamageNumbersCreated);
+
+	return DamageText;
+}
@@ -2,4 +2,59 @@
 
 
 #include "UI/VTDamageTextWidgetComponent.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+#include "UI/VTDamageNumberPoolSubsystem.h"
 
+UVTDamageTextWidgetComponent::UVTDamageTextWidgetComponent()
+{
+	Lifetime = 1.5f;
+	DamageAmount = 0.0f;
+	LastUpdateTime = 0.0f;
+	bInUse = false;
+}
+
+void UVTDamageTextWidgetComponent::ShowDamage(float Damage, const FGameplayTagContainer& Tags)
+{
+	DamageAmount = Damage;
+	DamageTags = Tags;
+
+	UWorld* World = GetWorld();
+	LastUpdateTime = World->GetTimeSeconds();
+	World->GetTimerManager().SetTimer(LifetimeTimer, this, &UVTDamageTextWidgetComponent::ReturnToPool, Lifetime, false);
+
+	SetDamageText(DamageAmount, DamageTags);
+}
+
+bool UVTDamageTextWidgetComponent::TryMergeDamage(const AActor* Target, float Damage, const FGameplayTagContainer& Tags, float MergeWindow)
+{
+	if (!bInUse || !Target || GetAttachParent() != Target->GetRootComponent()
+		|| GetWorld()->GetTimeSeconds() - LastUpdateTime > MergeWindow || Tags != DamageTags)
+	{
+		return false;
+	}
+
+	ShowDamage(DamageAmount + Damage, Tags);
+	return true;
+}
+
+void UVTDamageTextWidgetComponent::ReturnToPool()
+{
+	if (!bInUse)
+	{
+		return;
+	}
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(LifetimeTimer);
+
+		if (UVTDamageNumberPoolSubsystem* Pool = World->GetSubsystem<UVTDamageNumberPoolSubsystem>())
+		{
+			Pool->Release(this);
+			return;
+		}
+	}
+
+	DestroyComponent();
+}
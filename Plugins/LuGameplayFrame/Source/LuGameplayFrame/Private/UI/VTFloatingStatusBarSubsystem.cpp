@@ -0,0 +1,150 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "UI/VTFloatingStatusBarSubsystem.h"
+#include "Characters/VTCharacterBase.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "LuGameplayFrame.h"
+#include "UI/VTAttributeViewModel.h"
+#include "UI/VTFloatingStatusBarWidget.h"
+
+DECLARE_CYCLE_STAT(TEXT("Floating Status Bar Update"), STAT_VTFloatingStatusBarUpdate, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floating Status Bar Pushes"), STAT_VTFloatingStatusBarPushes, STATGROUP_LuGameplayFrame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Floating Status Bars Culled"), STAT_VTFloatingStatusBarsCulled, STATGROUP_LuGameplayFrame);
+
+static TAutoConsoleVariable<float> CVarStatusBarMaxDistance(
+	TEXT("VT.StatusBars.MaxDistance"),
+	5000.0f,
+	TEXT("Floating status bars further than this from every local player are not updated")
+);
+
+static TAutoConsoleVariable<float> CVarStatusBarRenderedTime(
+	TEXT("VT.StatusBars.RenderedTime"),
+	0.2f,
+	TEXT("A character counts as on screen if it was rendered within this many seconds")
+);
+
+bool UVTFloatingStatusBarSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_SERVER
+	return false;
+#else
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->GetNetMode() != NM_DedicatedServer && World->IsGameWorld();
+#endif
+}
+
+void UVTFloatingStatusBarSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_VTFloatingStatusBarUpdate);
+
+	UWorld* World = GetWorld();
+
+	ViewLocations.Reset();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	const float Now = World->GetTimeSeconds();
+	const float MaxDistanceSquared = FMath::Square(CVarStatusBarMaxDistance.GetValueOnGameThread());
+	const float RenderedTime = CVarStatusBarRenderedTime.GetValueOnGameThread();
+	const EVTAttributeViewField StatusBarFields = EVTAttributeViewField::Health | EVTAttributeViewField::Mana | EVTAttributeViewField::Shield;
+
+	for (int32 Index = StatusBars.Num() - 1; Index >= 0; --Index)
+	{
+		FStatusBarEntry& Entry = StatusBars[Index];
+		UVTFloatingStatusBarWidget* StatusBar = Entry.StatusBar.Get();
+		UVTAttributeViewModel* ViewModel = Entry.ViewModel.Get();
+		AVTCharacterBase* Character = ViewModel ? Cast<AVTCharacterBase>(ViewModel->GetOuter()) : nullptr;
+		if (!StatusBar || !Character)
+		{
+			StatusBars.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (Entry.PushedSerial == ViewModel->GetViewSerial() && !Entry.bNeedsSnap)
+		{
+			continue;
+		}
+
+		bool bInRange = false;
+		const FVector CharacterLocation = Character->GetActorLocation();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			if (FVector::DistSquared(ViewLocation, CharacterLocation) <= MaxDistanceSquared)
+			{
+				bInRange = true;
+				break;
+			}
+		}
+
+		const float UpdateInterval = Character->GetFloatingStatusBarUpdateInterval();
+		if (!bInRange || UpdateInterval < 0.0f || !Character->WasRecentlyRendered(RenderedTime))
+		{
+			INC_DWORD_STAT(STAT_VTFloatingStatusBarsCulled);
+			Entry.bNeedsSnap = true;
+			continue;
+		}
+
+		if (!Entry.bNeedsSnap && Now - Entry.LastPushTime < UpdateInterval)
+		{
+			continue;
+		}
+
+		const EVTAttributeViewField Fields = Entry.bNeedsSnap ? StatusBarFields : ViewModel->GetFieldsChangedSince(Entry.PushedSerial) & StatusBarFields;
+
+		Entry.PushedSerial = ViewModel->GetViewSerial();
+		Entry.LastPushTime = Now;
+		Entry.bNeedsSnap = false;
+
+		if (Fields != EVTAttributeViewField::None)
+		{
+			INC_DWORD_STAT(STAT_VTFloatingStatusBarPushes);
+			StatusBar->UpdateAttributes(ViewModel->GetView(), static_cast<int32>(Fields));
+		}
+	}
+}
+
+TStatId UVTFloatingStatusBarSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UVTFloatingStatusBarSubsystem, STATGROUP_Tickables);
+}
+
+void UVTFloatingStatusBarSubsystem::RegisterStatusBar(UVTFloatingStatusBarWidget* StatusBar, UVTAttributeViewModel* ViewModel)
+{
+	for (FStatusBarEntry& Entry : StatusBars)
+	{
+		if (Entry.StatusBar == StatusBar)
+		{
+			Entry.ViewModel = ViewModel;
+			Entry.bNeedsSnap = true;
+			return;
+		}
+	}
+
+	FStatusBarEntry& Entry = StatusBars.AddDefaulted_GetRef();
+	Entry.StatusBar = StatusBar;
+	Entry.ViewModel = ViewModel;
+}
+
+void UVTFloatingStatusBarSubsystem::UnregisterStatusBar(UVTFloatingStatusBarWidget* StatusBar)
+{
+	StatusBars.RemoveAllSwap([StatusBar](const FStatusBarEntry& Entry)
+	{
+		return Entry.StatusBar == StatusBar;
+	});
+}
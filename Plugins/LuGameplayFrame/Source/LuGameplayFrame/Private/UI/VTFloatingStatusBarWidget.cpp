@@ -3,3 +3,22 @@
 
 #include "UI/VTFloatingStatusBarWidget.h"
 
+void UVTFloatingStatusBarWidget::UpdateAttributes_Implementation(const FVTAttributeView& View, int32 DirtyFields)
+{
+	const EVTAttributeViewField Fields = static_cast<EVTAttributeViewField>(DirtyFields);
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Health))
+	{
+		SetHealthPercentage(View.HealthPercentage);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Mana))
+	{
+		SetManaPercentage(View.ManaPercentage);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Shield))
+	{
+		SetShieldPercentage(View.ShieldPercentage);
+	}
+}
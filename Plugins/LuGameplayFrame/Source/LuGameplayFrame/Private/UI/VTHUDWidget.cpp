@@ -3,3 +3,58 @@
 
 #include "UI/VTHUDWidget.h"
 
+void UVTHUDWidget::UpdateAttributes_Implementation(const FVTAttributeView& View, int32 DirtyFields)
+{
+	const EVTAttributeViewField Fields = static_cast<EVTAttributeViewField>(DirtyFields);
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Health))
+	{
+		SetMaxHealth(View.MaxHealth);
+		SetCurrentHealth(View.Health);
+		SetHealthPercentage(View.HealthPercentage);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Mana))
+	{
+		SetMaxMana(View.MaxMana);
+		SetCurrentMana(View.Mana);
+		SetManaPercentage(View.ManaPercentage);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Stamina))
+	{
+		SetMaxStamina(View.MaxStamina);
+		SetCurrentStamina(View.Stamina);
+		SetStaminaPercentage(View.StaminaPercentage);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Shield))
+	{
+		SetMaxShield(View.MaxShield);
+		SetCurrentShield(View.Shield);
+		SetShieldPercentage(View.ShieldPercentage);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::RegenRates))
+	{
+		SetHealthRegenRate(View.HealthRegenRate);
+		SetManaRegenRate(View.ManaRegenRate);
+		SetStaminaRegenRate(View.StaminaRegenRate);
+		SetShieldRegenRate(View.ShieldRegenRate);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Experience))
+	{
+		SetExperience(View.Experience);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::Gold))
+	{
+		SetGold(View.Gold);
+	}
+
+	if (EnumHasAnyFlags(Fields, EVTAttributeViewField::CharacterLevel))
+	{
+		SetHeroLevel(View.CharacterLevel);
+	}
+}
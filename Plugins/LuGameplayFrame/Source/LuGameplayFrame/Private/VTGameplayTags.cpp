@@ -0,0 +1,21 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "VTGameplayTags.h"
+
+namespace VTGameplayTags
+{
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(State_Dead, "State.Dead", "Character is dead. Blocks ability activation.");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(State_KnockedDown, "State.KnockedDown", "Character is knocked down. Blocks ability activation.");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(State_Interacting, "State.Interacting", "Character is interacting with something.");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(State_InteractingRemoval, "State.InteractingRemoval", "Interaction is being removed this frame.");
+
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Ability_BlocksInteraction, "Ability.BlocksInteraction", "Owned while an ability that prevents interacting is active.");
+
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Effect_RemoveOnDeath, "Effect.RemoveOnDeath", "Effects with this tag are removed when the character dies.");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Effect_Damage_HeadShot, "Effect.Damage.HeadShot", "Damage was a headshot.");
+
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Weapon_Ammo_Rifle, "Weapon.Ammo.Rifle", "Rifle reserve ammo.");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Weapon_Ammo_Rocket, "Weapon.Ammo.Rocket", "Rocket reserve ammo.");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Weapon_Ammo_Shotgun, "Weapon.Ammo.Shotgun", "Shotgun reserve ammo.");
+}
@@ -0,0 +1,308 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Visibility/VTBakePotentialVisibilityCommandlet.h"
+#include "Async/ParallelFor.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Visibility/VTPotentialVisibilitySubsystem.h"
+
+namespace VTBakePVS
+{
+	// Center first so most visible pairs early out on the first trace
+	static const FVector SampleOffsets[] =
+	{
+		FVector(0.f, 0.f, 0.f),
+		FVector(0.35f, 0.35f, 0.25f),
+		FVector(-0.35f, -0.35f, 0.25f),
+		FVector(0.35f, -0.35f, -0.25f),
+		FVector(-0.35f, 0.35f, -0.25f),
+	};
+
+	// Memory is NumCells^2 bits and the bake NumCells^2 / 2 cell pairs, 16k cells is 32MB and ~134M pairs
+	static constexpr int64 DefaultMaxCells = 16384;
+
+	// -Bounds=MinX,MinY,MinZ,MaxX,MaxY,MaxZ
+	static bool ParseBounds(const FString& BoundsString, FBox& OutBounds)
+	{
+		TArray<FString> Values;
+		BoundsString.ParseIntoArray(Values, TEXT(","));
+		if (Values.Num() != 6)
+		{
+			return false;
+		}
+
+		OutBounds = FBox(
+			FVector(FCString::Atod(*Values[0]), FCString::Atod(*Values[1]), FCString::Atod(*Values[2])),
+			FVector(FCString::Atod(*Values[3]), FCString::Atod(*Values[4]), FCString::Atod(*Values[5])));
+		return OutBounds.IsValid && OutBounds.GetVolume() > 0.0;
+	}
+
+	// Bounds of the actor named or labelled VolumeName, usually a blocking or trigger volume around the play space
+	static FBox FindVolumeBounds(UWorld* World, const FString& VolumeName)
+	{
+		for (AActor* Actor : World->PersistentLevel->Actors)
+		{
+			if (!Actor)
+			{
+				continue;
+			}
+
+#if WITH_EDITOR
+			const bool bLabelMatches = Actor->GetActorLabel() == VolumeName;
+#else
+			const bool bLabelMatches = false;
+#endif
+			if (Actor->GetName() == VolumeName || bLabelMatches)
+			{
+				return Actor->GetComponentsBoundingBox(true);
+			}
+		}
+
+		return FBox(ForceInit);
+	}
+}
+
+UVTBakePotentialVisibilityCommandlet::UVTBakePotentialVisibilityCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UVTBakePotentialVisibilityCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() Usage: -run=VTBakePotentialVisibility -Map=/Game/Maps/Foo [-CellSize=400] [-Samples=5] [-Output=Path] [-Bounds=MinX,MinY,MinZ,MaxX,MaxY,MaxZ | -BoundsVolume=ActorName] [-MaxCells=16384]"), *FString(__FUNCTION__));
+		return 1;
+	}
+
+	float CellSize = 400.f;
+	FParse::Value(*Params, TEXT("CellSize="), CellSize);
+	CellSize = FMath::Max(CellSize, 50.f);
+
+	int32 NumSamples = UE_ARRAY_COUNT(VTBakePVS::SampleOffsets);
+	FParse::Value(*Params, TEXT("Samples="), NumSamples);
+	NumSamples = FMath::Clamp(NumSamples, 1, (int32)UE_ARRAY_COUNT(VTBakePVS::SampleOffsets));
+
+	FString OutputFilename = UVTPotentialVisibilitySubsystem::GetPVSFilename(MapName);
+	FParse::Value(*Params, TEXT("Output="), OutputFilename);
+
+	int64 MaxCells = VTBakePVS::DefaultMaxCells;
+	FParse::Value(*Params, TEXT("MaxCells="), MaxCells);
+	MaxCells = FMath::Clamp<int64>(MaxCells, 1, MAX_int32);
+
+	FBox Bounds(ForceInit);
+	FString BoundsString;
+	if (FParse::Value(*Params, TEXT("Bounds="), BoundsString, false) && !VTBakePVS::ParseBounds(BoundsString, Bounds))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() -Bounds=%s is not MinX,MinY,MinZ,MaxX,MaxY,MaxZ"), *FString(__FUNCTION__), *BoundsString);
+		return 1;
+	}
+
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() Could not load map %s"), *FString(__FUNCTION__), *MapName);
+		return 1;
+	}
+
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+	if (!World->bIsWorldInitialized)
+	{
+		// Only collision is needed for the traces
+		World->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(true)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false));
+	}
+	World->UpdateWorldComponents(true, false);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// The whole level bounds include sky spheres and other far away meshes, prefer an explicit play space
+	FString VolumeName;
+	if (!Bounds.IsValid && FParse::Value(*Params, TEXT("BoundsVolume="), VolumeName))
+	{
+		Bounds = VTBakePVS::FindVolumeBounds(World, VolumeName);
+		if (!Bounds.IsValid)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s() %s has no actor named %s"), *FString(__FUNCTION__), *MapName, *VolumeName);
+			World->RemoveFromRoot();
+			return 1;
+		}
+	}
+
+	if (!Bounds.IsValid)
+	{
+		Bounds = ALevelBounds::CalculateLevelBounds(World->PersistentLevel);
+	}
+
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() %s has no level bounds"), *FString(__FUNCTION__), *MapName);
+		World->RemoveFromRoot();
+		return 1;
+	}
+
+	const int64 CellsX = FMath::Max<int64>(1, FMath::CeilToInt64(Bounds.GetSize().X / CellSize));
+	const int64 CellsY = FMath::Max<int64>(1, FMath::CeilToInt64(Bounds.GetSize().Y / CellSize));
+	const int64 CellsZ = FMath::Max<int64>(1, FMath::CeilToInt64(Bounds.GetSize().Z / CellSize));
+	const int64 NumCells = CellsX * CellsY * CellsZ;
+	if (NumCells > MaxCells)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() %s bounds %s need %lld cells of %.0f, more than -MaxCells=%lld. Pass -Bounds= or -BoundsVolume= around the play space, a larger -CellSize, or raise -MaxCells."),
+			*FString(__FUNCTION__), *MapName, *Bounds.ToString(), NumCells, CellSize, MaxCells);
+		World->RemoveFromRoot();
+		return 1;
+	}
+
+	FVTPotentialVisibilityHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = FVTPotentialVisibilityHeader::ExpectedMagic;
+	Header.Version = FVTPotentialVisibilityHeader::ExpectedVersion;
+	Header.CellSize = CellSize;
+	Header.OriginX = Bounds.Min.X;
+	Header.OriginY = Bounds.Min.Y;
+	Header.OriginZ = Bounds.Min.Z;
+	Header.CellsX = int32(CellsX);
+	Header.CellsY = int32(CellsY);
+	Header.CellsZ = int32(CellsZ);
+	Header.NumCells = int32(NumCells);
+	Header.WordsPerRow = (Header.NumCells + 63) / 64;
+
+	const int64 NumPairs = NumCells * (NumCells - 1) / 2;
+	UE_LOG(LogTemp, Display, TEXT("%s() Baking %s: %d x %d x %d cells of %.0f, %d samples per cell, %lld cell pairs, %lld bytes"), *FString(__FUNCTION__),
+		*MapName, Header.CellsX, Header.CellsY, Header.CellsZ, CellSize, NumSamples, NumPairs, Header.GetDataSize());
+
+	auto GetCellCenter = [&Header](int32 Cell)
+	{
+		const int32 X = Cell % Header.CellsX;
+		const int32 Y = (Cell / Header.CellsX) % Header.CellsY;
+		const int32 Z = Cell / (Header.CellsX * Header.CellsY);
+		return FVector(Header.OriginX, Header.OriginY, Header.OriginZ) + (FVector(X, Y, Z) + 0.5f) * Header.CellSize;
+	};
+
+	TArray<uint64> Rows;
+	Rows.SetNumZeroed(int64(Header.NumCells) * Header.WordsPerRow);
+
+	auto SetBit = [&Rows, &Header](int32 From, int32 To)
+	{
+		Rows[int64(From) * Header.WordsPerRow + (To >> 6)] |= uint64(1) << (To & 63);
+	};
+	auto TestBit = [&Rows, &Header](int32 From, int32 To)
+	{
+		return (Rows[int64(From) * Header.WordsPerRow + (To >> 6)] & (uint64(1) << (To & 63))) != 0;
+	};
+
+	// Upper triangle only, each row is owned by one task so no locking
+	ParallelFor(Header.NumCells, [&](int32 From)
+	{
+		const FVector FromCenter = GetCellCenter(From);
+		SetBit(From, From);
+		for (int32 To = From + 1; To < Header.NumCells; To++)
+		{
+			if (AreCellsVisible(World, FromCenter, GetCellCenter(To), CellSize, NumSamples))
+			{
+				SetBit(From, To);
+			}
+		}
+	});
+
+	for (int32 From = 0; From < Header.NumCells; From++)
+	{
+		for (int32 To = From + 1; To < Header.NumCells; To++)
+		{
+			if (TestBit(From, To))
+			{
+				SetBit(To, From);
+			}
+		}
+	}
+
+	// Sampling can miss thin gaps, so also count a cell as visible if any of its neighbors are
+	TArray<uint64> DilatedRows = Rows;
+	ParallelFor(Header.NumCells, [&](int32 From)
+	{
+		uint64* DilatedRow = &DilatedRows[int64(From) * Header.WordsPerRow];
+		for (int32 To = 0; To < Header.NumCells; To++)
+		{
+			if (!TestBit(From, To))
+			{
+				continue;
+			}
+
+			const int32 X = To % Header.CellsX;
+			const int32 Y = (To / Header.CellsX) % Header.CellsY;
+			const int32 Z = To / (Header.CellsX * Header.CellsY);
+			for (int32 DZ = FMath::Max(Z - 1, 0); DZ <= FMath::Min(Z + 1, Header.CellsZ - 1); DZ++)
+			{
+				for (int32 DY = FMath::Max(Y - 1, 0); DY <= FMath::Min(Y + 1, Header.CellsY - 1); DY++)
+				{
+					for (int32 DX = FMath::Max(X - 1, 0); DX <= FMath::Min(X + 1, Header.CellsX - 1); DX++)
+					{
+						const int32 Neighbor = (DZ * Header.CellsY + DY) * Header.CellsX + DX;
+						DilatedRow[Neighbor >> 6] |= uint64(1) << (Neighbor & 63);
+					}
+				}
+			}
+		}
+	});
+
+	TArray<uint8> FileData;
+	FileData.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	FileData.Append(reinterpret_cast<const uint8*>(DilatedRows.GetData()), DilatedRows.Num() * sizeof(uint64));
+
+	const double BakeTime = FPlatformTime::Seconds() - StartTime;
+
+	World->RemoveFromRoot();
+
+	if (!FFileHelper::SaveArrayToFile(FileData, *OutputFilename))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() Could not write %s"), *FString(__FUNCTION__), *OutputFilename);
+		return 1;
+	}
+
+	int64 VisiblePairs = 0;
+	for (const uint64 Word : DilatedRows)
+	{
+		VisiblePairs += FMath::CountBits(Word);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("%s() Wrote %s: %d cells, %lld bytes, %.1f%% of pairs potentially visible, baked in %.2fs"), *FString(__FUNCTION__),
+		*OutputFilename, Header.NumCells, IFileManager::Get().FileSize(*OutputFilename),
+		100.0 * double(VisiblePairs) / (double(Header.NumCells) * Header.NumCells), BakeTime);
+
+	return 0;
+}
+
+bool UVTBakePotentialVisibilityCommandlet::AreCellsVisible(UWorld* World, const FVector& CenterA, const FVector& CenterB, float CellSize, int32 NumSamples) const
+{
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(VTBakePVS), false);
+
+	for (int32 SampleA = 0; SampleA < NumSamples; SampleA++)
+	{
+		const FVector Start = CenterA + VTBakePVS::SampleOffsets[SampleA] * CellSize;
+		for (int32 SampleB = 0; SampleB < NumSamples; SampleB++)
+		{
+			const FVector End = CenterB + VTBakePVS::SampleOffsets[SampleB] * CellSize;
+			if (!World->LineTraceTestByChannel(Start, End, ECC_Visibility, Params))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
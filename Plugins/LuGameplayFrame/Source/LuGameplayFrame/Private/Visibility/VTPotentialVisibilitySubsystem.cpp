@@ -0,0 +1,126 @@
+// Copyright 2024 Dan Kestranek.
+
+
+#include "Visibility/VTPotentialVisibilitySubsystem.h"
+#include "Async/MappedFileHandle.h"
+#include "Engine/World.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+bool UVTPotentialVisibilitySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+	{
+		return false;
+	}
+
+	// Only the server does relevancy and AI
+	UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && World->GetNetMode() != NM_Client;
+}
+
+void UVTPotentialVisibilitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const FString Filename = GetPVSFilename(InWorld.GetMapName());
+	if (FPaths::FileExists(Filename))
+	{
+		LoadPVS(Filename);
+	}
+}
+
+void UVTPotentialVisibilitySubsystem::Deinitialize()
+{
+	Header = nullptr;
+	Rows = nullptr;
+	MappedRegion.Reset();
+	MappedFile.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UVTPotentialVisibilitySubsystem::IsPotentiallyVisible(const FVector& From, const FVector& To) const
+{
+	return IsCellPotentiallyVisible(GetCellIndex(From), GetCellIndex(To));
+}
+
+bool UVTPotentialVisibilitySubsystem::IsCellPotentiallyVisible(int32 FromCell, int32 ToCell) const
+{
+	if (!Header || FromCell == INDEX_NONE || ToCell == INDEX_NONE)
+	{
+		return true;
+	}
+
+	const uint64 Word = Rows[int64(FromCell) * Header->WordsPerRow + (ToCell >> 6)];
+	return (Word & (uint64(1) << (ToCell & 63))) != 0;
+}
+
+int32 UVTPotentialVisibilitySubsystem::GetCellIndex(const FVector& Location) const
+{
+	if (!Header)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 X = FMath::FloorToInt((Location.X - Header->OriginX) / Header->CellSize);
+	const int32 Y = FMath::FloorToInt((Location.Y - Header->OriginY) / Header->CellSize);
+	const int32 Z = FMath::FloorToInt((Location.Z - Header->OriginZ) / Header->CellSize);
+
+	if (X < 0 || Y < 0 || Z < 0 || X >= Header->CellsX || Y >= Header->CellsY || Z >= Header->CellsZ)
+	{
+		return INDEX_NONE;
+	}
+
+	return (Z * Header->CellsY + Y) * Header->CellsX + X;
+}
+
+FString UVTPotentialVisibilitySubsystem::GetPVSFilename(const FString& MapName)
+{
+	// Staged as a loose file (DirectoriesToAlwaysStageAsNonUFS) so it can be memory mapped
+	return FPaths::ProjectContentDir() / TEXT("PVS") / (FPackageName::GetShortName(MapName) + TEXT(".vpvs"));
+}
+
+bool UVTPotentialVisibilitySubsystem::LoadPVS(const FString& Filename)
+{
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s() Could not memory map %s"), *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	const int64 FileSize = MappedFile->GetFileSize();
+	if (FileSize < int64(sizeof(FVTPotentialVisibilityHeader)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() %s is too small to be a PVS file"), *FString(__FUNCTION__), *Filename);
+		MappedFile.Reset();
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, FileSize));
+	if (!MappedRegion)
+	{
+		MappedFile.Reset();
+		return false;
+	}
+
+	const FVTPotentialVisibilityHeader* MappedHeader = reinterpret_cast<const FVTPotentialVisibilityHeader*>(MappedRegion->GetMappedPtr());
+	if (MappedHeader->Magic != FVTPotentialVisibilityHeader::ExpectedMagic || MappedHeader->Version != FVTPotentialVisibilityHeader::ExpectedVersion
+		|| MappedHeader->NumCells != MappedHeader->CellsX * MappedHeader->CellsY * MappedHeader->CellsZ
+		|| MappedHeader->WordsPerRow != (MappedHeader->NumCells + 63) / 64
+		|| int64(sizeof(FVTPotentialVisibilityHeader)) + MappedHeader->GetDataSize() > FileSize)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() %s is corrupt or from an older version. Rebake it."), *FString(__FUNCTION__), *Filename);
+		MappedRegion.Reset();
+		MappedFile.Reset();
+		return false;
+	}
+
+	Header = MappedHeader;
+	Rows = reinterpret_cast<const uint64*>(MappedRegion->GetMappedPtr() + sizeof(FVTPotentialVisibilityHeader));
+
+	UE_LOG(LogTemp, Log, TEXT("%s() Mapped %s: %d cells of %.0f, %lld bytes"), *FString(__FUNCTION__), *Filename, Header->NumCells, Header->CellSize, FileSize);
+	return true;
+}
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "AttributeSet.h"
 #include "AbilitySystemComponent.h"
+#include "Engine/DataTable.h"
 #include "GSAmmoAttributeSet.generated.h"
 
 // Uses macros from AttributeSet.h
@@ -15,76 +16,140 @@
 	GAMEPLAYATTRIBUTE_VALUE_INITTER(PropertyName)
 
 /**
- * 
- */
-UCLASS()
-class GASSHOOTER_API UGSAmmoAttributeSet : public UAttributeSet
+* One ammo type. Slot picks the ReserveAmmoN/MaxReserveAmmoN pair the type uses. It is stored in the row rather than taken
+* from row order so clients and servers agree on it however the table was built, and so adding a type doesn't move the others.
+*/
+USTRUCT(BlueprintType)
+struct LUGAMEPLAYFRAME_API FGSAmmoTypeRow : public FTableRowBase
 {
 	GENERATED_BODY()
 
-public:
-	UGSAmmoAttributeSet();
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ammo", Meta = (Categories = "Weapon.Ammo"))
+	FGameplayTag AmmoTag;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_RifleReserveAmmo)
-	FGameplayAttributeData RifleReserveAmmo;
-	ATTRIBUTE_ACCESSORS(UGSAmmoAttributeSet, RifleReserveAmmo)
+	// 0 to UGSAmmoAttributeSet::NumAmmoSlots - 1, unique within the table
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ammo", Meta = (ClampMin = "0"))
+	int32 Slot = INDEX_NONE;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxRifleReserveAmmo)
-	FGameplayAttributeData MaxRifleReserveAmmo;
-	ATTRIBUTE_ACCESSORS(UGSAmmoAttributeSet, MaxRifleReserveAmmo)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ammo")
+	float MaxReserveAmmo = 0.0f;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_RocketReserveAmmo)
-	FGameplayAttributeData RocketReserveAmmo;
-	ATTRIBUTE_ACCESSORS(UGSAmmoAttributeSet, RocketReserveAmmo)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ammo")
+	float StartingReserveAmmo = 0.0f;
+};
 
-	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxRocketReserveAmmo)
-	FGameplayAttributeData MaxRocketReserveAmmo;
-	ATTRIBUTE_ACCESSORS(UGSAmmoAttributeSet, MaxRocketReserveAmmo)
+/**
+* Reserve ammo in fixed slots. Ammo tags map to slots through the ammo type table (see InitAmmoTypes).
+* Each slot is its own replicated attribute, so only the slots that changed are sent.
+*/
+UCLASS()
+class GASSHOOTER_API UGSAmmoAttributeSet : public UAttributeSet
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Most ammo types a project can have. UHT needs every slot's properties and OnReps spelled out, so adding a slot is the
+	* four one line declarations below, one GS_AMMO_SLOT line in the .cpp and bumping this. The slot table is built from
+	* the ReserveAmmoN/MaxReserveAmmoN properties by name and checks that exactly this many exist.
+	*/
+	static constexpr int32 NumAmmoSlots = 12;
 
-	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ShotgunReserveAmmo)
-	FGameplayAttributeData ShotgunReserveAmmo;
-	ATTRIBUTE_ACCESSORS(UGSAmmoAttributeSet, ShotgunReserveAmmo)
+	UGSAmmoAttributeSet();
 
-	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxShotgunReserveAmmo)
-	FGameplayAttributeData MaxShotgunReserveAmmo;
-	ATTRIBUTE_ACCESSORS(UGSAmmoAttributeSet, MaxShotgunReserveAmmo)
+	// Starting values come from the ammo type table
+	virtual void PostInitProperties() override;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo0) FGameplayAttributeData ReserveAmmo0;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo1) FGameplayAttributeData ReserveAmmo1;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo2) FGameplayAttributeData ReserveAmmo2;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo3) FGameplayAttributeData ReserveAmmo3;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo4) FGameplayAttributeData ReserveAmmo4;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo5) FGameplayAttributeData ReserveAmmo5;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo6) FGameplayAttributeData ReserveAmmo6;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo7) FGameplayAttributeData ReserveAmmo7;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo8) FGameplayAttributeData ReserveAmmo8;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo9) FGameplayAttributeData ReserveAmmo9;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo10) FGameplayAttributeData ReserveAmmo10;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_ReserveAmmo11) FGameplayAttributeData ReserveAmmo11;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo0) FGameplayAttributeData MaxReserveAmmo0;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo1) FGameplayAttributeData MaxReserveAmmo1;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo2) FGameplayAttributeData MaxReserveAmmo2;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo3) FGameplayAttributeData MaxReserveAmmo3;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo4) FGameplayAttributeData MaxReserveAmmo4;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo5) FGameplayAttributeData MaxReserveAmmo5;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo6) FGameplayAttributeData MaxReserveAmmo6;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo7) FGameplayAttributeData MaxReserveAmmo7;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo8) FGameplayAttributeData MaxReserveAmmo8;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo9) FGameplayAttributeData MaxReserveAmmo9;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo10) FGameplayAttributeData MaxReserveAmmo10;
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", ReplicatedUsing = OnRep_MaxReserveAmmo11) FGameplayAttributeData MaxReserveAmmo11;
 
-	virtual void PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue) override;
 	virtual void PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	/**
+	* Maps the tags of AmmoTypeTable to the slots their rows name. Rows with a slot out of range, or a slot or tag already
+	* taken, are rejected. Without a table the rifle, rocket and shotgun tags take slots 0 to 2.
+	* Called from UGSAbilitySystemGlobals::InitGlobalData, before any ammo set is created.
+	*/
+	static void InitAmmoTypes(const UDataTable* AmmoTypeTable);
+
+	// INDEX_NONE for tags without a slot
+	static int32 GetAmmoSlotForTag(const FGameplayTag& AmmoTag);
+
+	static FGameplayAttribute GetReserveAmmoAttributeForSlot(int32 Slot);
+	static FGameplayAttribute GetMaxReserveAmmoAttributeForSlot(int32 Slot);
+
 	static FGameplayAttribute GetReserveAmmoAttributeFromTag(FGameplayTag& PrimaryAmmoTag);
 	static FGameplayAttribute GetMaxReserveAmmoAttributeFromTag(FGameplayTag& PrimaryAmmoTag);
 
-protected:
-	// Cache tags
-	FGameplayTag RifleAmmoTag;
-	FGameplayTag RocketAmmoTag;
-	FGameplayTag ShotgunAmmoTag;
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Ammo")
+	float GetReserveAmmoForTag(FGameplayTag AmmoTag) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Ammo")
+	float GetMaxReserveAmmoForTag(FGameplayTag AmmoTag) const;
 
-	// Helper function to proportionally adjust the value of an attribute when it's associated max attribute changes.
-	// (i.e. When MaxHealth increases, Health increases by an amount that maintains the same percentage as before)
-	void AdjustAttributeForMaxChange(FGameplayAttributeData& AffectedAttribute, const FGameplayAttributeData& MaxAttribute, float NewMaxValue, const FGameplayAttribute& AffectedAttributeProperty);
+	// Server only. Sets every reserve to its max, for round resets.
+	void RefillReserveAmmo();
+
+protected:
+	FGameplayAttributeData* GetReserveAmmoData(int32 Slot);
+	FGameplayAttributeData* GetMaxReserveAmmoData(int32 Slot);
+	const FGameplayAttributeData* GetReserveAmmoData(int32 Slot) const;
+	const FGameplayAttributeData* GetMaxReserveAmmoData(int32 Slot) const;
 
 	/**
 	* These OnRep functions exist to make sure that the ability system internal representations are synchronized properly during replication
 	**/
-	
-	UFUNCTION()
-	virtual void OnRep_RifleReserveAmmo(const FGameplayAttributeData& OldRifleReserveAmmo);
-
-	UFUNCTION()
-	virtual void OnRep_MaxRifleReserveAmmo(const FGameplayAttributeData& OldMaxRifleReserveAmmo);
-
-	UFUNCTION()
-	virtual void OnRep_RocketReserveAmmo(const FGameplayAttributeData& OldRocketReserveAmmo);
-
-	UFUNCTION()
-	virtual void OnRep_MaxRocketReserveAmmo(const FGameplayAttributeData& OldMaxRocketReserveAmmo);
-
-	UFUNCTION()
-	virtual void OnRep_ShotgunReserveAmmo(const FGameplayAttributeData& OldShotgunReserveAmmo);
 
-	UFUNCTION()
-	virtual void OnRep_MaxShotgunReserveAmmo(const FGameplayAttributeData& OldMaxShotgunReserveAmmo);
+	UFUNCTION() virtual void OnRep_ReserveAmmo0(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo1(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo2(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo3(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo4(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo5(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo6(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo7(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo8(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo9(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo10(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_ReserveAmmo11(const FGameplayAttributeData& OldValue);
+
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo0(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo1(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo2(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo3(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo4(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo5(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo6(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo7(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo8(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo9(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo10(const FGameplayAttributeData& OldValue);
+	UFUNCTION() virtual void OnRep_MaxReserveAmmo11(const FGameplayAttributeData& OldValue);
+
+	// Shared body of the OnReps above
+	void OnRepAmmoSlot(const FGameplayAttribute& Attribute, const FGameplayAttributeData& OldValue);
 };
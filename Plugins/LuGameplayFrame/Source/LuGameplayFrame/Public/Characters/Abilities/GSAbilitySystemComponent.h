@@ -69,6 +69,15 @@ public:
 	}
 };
 
+/**
+* Longest running duration effect granting a tag. Kept up to date from effect events so the HUD never scans the container.
+*/
+struct FGSCooldownCacheEntry
+{
+	float EndTime = 0.0f;
+	float Duration = 0.0f;
+};
+
 /**
  * 
  */
@@ -85,24 +94,98 @@ public:
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	// True when the avatar is an AVTCharacterBase that isn't our owner. RepAnimMontageInfoForMeshes then replicates with
+	// the avatar, because the owner (PlayerState) is relevant to everyone and would leak hidden enemies' montages.
+	bool ReplicatesMontagesThroughAvatar() const;
+
+	const TArray<FGameplayAbilityRepAnimMontageForMesh>& GetRepAnimMontageInfoForMeshes() const { return RepAnimMontageInfoForMeshes; }
+
+	// Client. Montage info that arrived with the avatar.
+	void SetRepAnimMontageInfoFromAvatar(const TArray<FGameplayAbilityRepAnimMontageForMesh>& InRepAnimMontageInfo);
+
 	virtual bool GetShouldTick() const override;
 
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 	virtual void InitAbilityActorInfo(AActor* InOwnerActor, AActor* InAvatarActor) override;
 
+	virtual void NotifyAbilityActivated(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability) override;
+
 	virtual void NotifyAbilityEnded(FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, bool bWasCancelled) override;
 
+	virtual void NotifyAbilityFailed(const FGameplayAbilitySpecHandle Handle, UGameplayAbility* Ability, const FGameplayTagContainer& FailureReason) override;
+
 	// Version of function in AbilitySystemGlobals that returns correct type
 	static UGSAbilitySystemComponent* GetAbilitySystemComponentFromActor(const AActor* Actor, bool LookForComponent = false);
 
 	// Input bound to an ability is pressed
 	virtual void AbilityLocalInputPressed(int32 InputID) override;
 
+	// Input bound to an ability is released
+	virtual void AbilityLocalInputReleased(int32 InputID) override;
+
+	// Client. Pressed state of every ability input, one bit per InputID. Sent to the server in saved moves.
+	uint16 GetLocalAbilityInputMask() const { return LocalAbilityInputMask; }
+
+	// Client. Press and release edges for active bReplicateInputDirectly specs since the last saved move, then clears them.
+	// A press and release inside one move both survive, the held mask tells the server which came first.
+	void ConsumeLocalAbilityInputEdges(uint16& OutPressedEdges, uint16& OutReleasedEdges);
+
+	// Server. Applies the edges of one client move. Edges for an InputID with no active spec (its reliable activation
+	// hasn't arrived) are queued until one activates, so they never overtake the activation. Edges for an InputID
+	// that already has an active spec only go to the active specs.
+	void ServerApplyAbilityInputEdges(uint16 PressedEdges, uint16 ReleasedEdges, uint16 HeldMask);
+
+	// True when input edges go to the server in the avatar's saved moves instead of ServerSetInputPressed/Released RPCs
+	bool ShouldReplicateInputInMoves() const;
+
 	// Exposes GetTagCount to Blueprint
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Abilities", Meta = (DisplayName = "GetTagCount", ScriptName = "GetTagCount"))
 	int32 K2_GetTagCount(FGameplayTag TagToCheck) const;
 
+	// Seconds left on the longest duration effect granting CooldownTag (exact match), 0 if none. O(1), safe to call every frame.
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Abilities|Cooldown")
+	float GetCooldownRemaining(FGameplayTag CooldownTag) const;
+
+	// Same as GetCooldownRemaining but also returns the full duration, for progress bars
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Abilities|Cooldown")
+	bool GetCooldownRemainingAndDuration(FGameplayTag CooldownTag, float& TimeRemaining, float& Duration) const;
+
+	/**
+	* Same as TryActivateAbilitiesByTag, but candidates come from a tag index instead of a scan over every spec.
+	* Activates every ability whose AbilityTags has all of GameplayTagContainer. Use this node instead of the engine's
+	* TryActivateAbilitiesByTag, which can't be redirected because it isn't virtual. C++ callers call this explicitly.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Abilities", Meta = (Keywords = "TryActivateAbilitiesByTag"))
+	bool TryActivateAbilitiesByTagIndexed(const FGameplayTagContainer& GameplayTagContainer, bool bAllowRemoteActivation = true);
+
+	// Handles of abilities whose AbilityTags has all of GameplayTagContainer, from the tag index
+	void GetAbilitySpecHandlesByAllMatchingTags(const FGameplayTagContainer& GameplayTagContainer, TArray<FGameplayAbilitySpecHandle>& OutHandles);
+
+	// O(1) through the handle index, unlike FindAbilitySpecFromHandle. Don't hold on to the result across grants.
+	FGameplayAbilitySpec* FindAbilitySpecFromHandleIndexed(FGameplayAbilitySpecHandle Handle);
+
+	// Triggered abilities come from a per event tag cache, so no parent walk or spec scan per event
+	virtual int32 HandleGameplayEvent(FGameplayTag EventTag, const FGameplayEventData* Payload) override;
+
+	// Weapon whose abilities may activate when bSourceObjectMustEqualCurrentWeaponToActivate is set. Call on every weapon
+	// switch. Until the first call, UGSGameplayAbility falls back to asking the avatar for its current weapon.
+	void SetCurrentWeaponSource(UObject* NewWeaponSource);
+	UObject* GetCurrentWeaponSource() const { return CurrentWeaponSource; }
+	bool HasCurrentWeaponSource() const { return bHasCurrentWeaponSource; }
+
+	// More Interacting than InteractingRemoval tags. Kept current by tag events so CanActivateAbility doesn't count tags.
+	bool IsInteracting() const { return bIsInteracting; }
+
+	// Server only. Gives every spec under one scope lock and one allocation of ActivatableAbilities.
+	// Each spec is still marked dirty on its own like GiveAbility does. Falls back to GiveAbility while the list is scope locked.
+	void GiveAbilitiesBatched(const TArray<FGameplayAbilitySpec>& Specs, TArray<FGameplayAbilitySpecHandle>& OutHandles);
+
+	// Server only. Clears every handle in one pass over ActivatableAbilities with a single MarkArrayDirty.
+	void ClearAbilitiesBatched(const TArray<FGameplayAbilitySpecHandle>& Handles);
+
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Abilities")
 	FGameplayAbilitySpecHandle FindAbilitySpecHandleForClass(TSubclassOf<UGameplayAbility> AbilityClass, UObject* OptionalSourceObject=nullptr);
 
@@ -136,6 +219,35 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Abilities")
 	virtual bool BatchRPCTryActivateAbility(FGameplayAbilitySpecHandle InAbilityHandle, bool EndAbilityImmediately);
 
+	// BatchRPCTryActivateAbility for several abilities, e.g. switch weapon then fire. Their activate, target data and end
+	// calls go to the server in one RPC and are processed there in this order.
+	UFUNCTION(BlueprintCallable, Category = "Abilities")
+	virtual bool BatchRPCTryActivateAbilities(const TArray<FGameplayAbilitySpecHandle>& InAbilityHandles, bool EndAbilitiesImmediately);
+
+	/**
+	* Client only. Until the end of this frame, every finished per ability RPC batch is held back and sent together with the
+	* others in one ServerAbilityRPCMultiBatch. Flushed after actors tick, before the net driver sends.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Abilities")
+	void OpenAbilityRPCBatchWindow();
+
+	// FGSScopedAbilityRPCMultiBatcher calls these. Nested scopes send once, when the outermost one ends.
+	void BeginAbilityRPCMultiBatch();
+	void EndAbilityRPCMultiBatch();
+
+	virtual void EndServerAbilityRPCBatch(FGameplayAbilitySpecHandle AbilityHandle) override;
+
+	// Ability RPCs that go out on their own first send the batches queued before them, so the server sees them in order
+	virtual void CallServerTryActivateAbility(FGameplayAbilitySpecHandle AbilityToActivate, bool InputPressed, FPredictionKey PredictionKey) override;
+	virtual void CallServerSetReplicatedTargetData(FGameplayAbilitySpecHandle AbilityHandle, FPredictionKey AbilityOriginalPredictionKey, const FGameplayAbilityTargetDataHandle& ReplicatedTargetDataHandle, FGameplayTag ApplicationTag, FPredictionKey CurrentPredictionKey) override;
+	virtual void CallServerEndAbility(FGameplayAbilitySpecHandle AbilityToEnd, FGameplayAbilityActivationInfo ActivationInfo, FPredictionKey PredictionKey) override;
+
+	// Most batches one ServerAbilityRPCMultiBatch may carry. A compile time constant so client and server agree.
+	static constexpr int32 MaxAbilityRPCBatchesPerRPC = 16;
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerAbilityRPCMultiBatch(const TArray<FServerAbilityRPCBatch>& Batches);
+
 	UFUNCTION(BlueprintCallable, Category = "GameplayCue", Meta = (AutoCreateRefTerm = "GameplayCueParameters", GameplayTagFilter = "GameplayCue"))
 	void ExecuteGameplayCueLocal(const FGameplayTag GameplayCueTag, const FGameplayCueParameters& GameplayCueParameters);
 
@@ -219,7 +331,99 @@ public:
 	// Returns amount of time left in current section
 	float GetCurrentMontageSectionTimeLeftForMesh(USkeletalMeshComponent* InMesh);
 
+	// Server only. Clears montages, loose tags and effects so a pooled character starts its next life clean.
+	virtual void ResetForReuse();
+
 protected:
+	uint16 LocalAbilityInputMask = 0;
+	uint16 LocalAbilityInputPressedEdges = 0;
+	uint16 LocalAbilityInputReleasedEdges = 0;
+
+	struct FPendingAbilityInputEdge
+	{
+		FGameplayAbilitySpecHandle Handle;
+		bool bPressed;
+		double QueuedTime;
+	};
+
+	// Server. Move edges waiting for their spec to activate. Dropped when the activation fails, when another spec with
+	// the same InputID activates, or after PendingAbilityInputEdgeTimeout.
+	TArray<FPendingAbilityInputEdge> PendingAbilityInputEdges;
+
+	static constexpr double PendingAbilityInputEdgeTimeout = 1.0;
+
+	// Applies one edge the way ServerSetInputPressed/Released would, or queues it if the spec isn't active
+	void ServerApplyAbilityInputEdge(FGameplayAbilitySpec& Spec, bool bPressed, double QueuedTime);
+
+	void ApplyPendingAbilityInputEdges();
+
+	// Finished per ability batches waiting for the multi batch to end, in the order they finished
+	TArray<FServerAbilityRPCBatch> PendingAbilityRPCBatches;
+
+	int32 AbilityRPCMultiBatchDepth = 0;
+
+	FDelegateHandle AbilityRPCBatchWindowHandle;
+
+	void OnAbilityRPCBatchWindowEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	// Sends the queued batches now, whether or not a multi batch is open
+	void FlushPendingAbilityRPCBatches();
+
+	// Flush unless AbilityHandle has an open batch that the next call will go into
+	void FlushPendingAbilityRPCBatchesBeforeRPC(FGameplayAbilitySpecHandle AbilityHandle);
+
+	// Client. Batch RPCs sent and the batches they carried, which is what would have been sent without merging.
+	// Logged per second with VT.AbilityRPC.LogStats.
+	void RecordAbilityRPCs(int32 NumRPCs, int32 NumBatches);
+
+	int64 AbilityRPCsSent = 0;
+	int64 AbilityRPCBatchesSent = 0;
+	int64 AbilityRPCsSentAtWindowStart = 0;
+	int64 AbilityRPCBatchesSentAtWindowStart = 0;
+	double AbilityRPCStatsWindowStart = 0.0;
+
+	// Rebuilt on first use after any grant or removal
+	TMap<FGameplayAbilitySpecHandle, int32> SpecIndexByHandle;
+
+	// Keyed by every AbilityTag and its parents, so a lookup by any tag returns the specs that match it
+	TMap<FGameplayTag, TArray<FGameplayAbilitySpecHandle>> SpecHandlesByAbilityTag;
+
+	// Event tag -> abilities triggered by it or any of its parents. Filled lazily.
+	TMap<FGameplayTag, TSharedRef<const TArray<FGameplayAbilitySpecHandle>>> TriggeredHandlesByEventTag;
+
+	bool bAbilityIndexDirty = true;
+
+	virtual void OnGiveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+	virtual void OnRemoveAbility(FGameplayAbilitySpec& AbilitySpec) override;
+
+	void RebuildAbilityIndex();
+	TSharedRef<const TArray<FGameplayAbilitySpecHandle>> GetTriggeredHandlesForEvent(const FGameplayTag& EventTag);
+
+	UPROPERTY()
+	UObject* CurrentWeaponSource = nullptr;
+
+	bool bHasCurrentWeaponSource = false;
+	bool bIsInteracting = false;
+
+	FDelegateHandle InteractingTagHandle;
+	FDelegateHandle InteractingRemovalTagHandle;
+
+	void OnInteractingTagChanged(const FGameplayTag Tag, int32 NewCount);
+
+	// Keyed by every tag granted by an active duration effect
+	TMap<FGameplayTag, FGSCooldownCacheEntry> CooldownCache;
+
+	FDelegateHandle CooldownEffectAddedHandle;
+	FDelegateHandle CooldownEffectRemovedHandle;
+
+	void OnCooldownEffectAdded(UAbilitySystemComponent* Target, const FGameplayEffectSpec& SpecApplied, FActiveGameplayEffectHandle ActiveHandle);
+	void OnCooldownEffectRemoved(const FActiveGameplayEffect& RemovedEffect);
+	void OnCooldownEffectStackChanged(FActiveGameplayEffectHandle ActiveHandle, int32 NewStackCount, int32 PreviousStackCount);
+	void OnCooldownEffectTimeChanged(FActiveGameplayEffectHandle ActiveHandle, float NewStartTime, float NewDuration);
+
+	// Rebuilds the cache entries for Tags from the active effects, skipping IgnoreHandle
+	void UpdateCooldownCache(const FGameplayTagContainer& Tags, FActiveGameplayEffectHandle IgnoreHandle = FActiveGameplayEffectHandle());
+
 	// ----------------------------------------------------------------------------------------------------------------
 	//	AnimMontage Support for multiple USkeletalMeshComponents on the AvatarActor.
 	//  Only one ability can be animating at a time though?
@@ -278,3 +482,15 @@ protected:
 	void ServerCurrentMontageSetPlayRateForMesh_Implementation(USkeletalMeshComponent* InMesh, UAnimMontage* ClientAnimMontage, float InPlayRate);
 	bool ServerCurrentMontageSetPlayRateForMesh_Validate(USkeletalMeshComponent* InMesh, UAnimMontage* ClientAnimMontage, float InPlayRate);
 };
+
+/**
+* Merges the server ability RPC batches of every ability activated in this scope into one RPC.
+*/
+struct LUGAMEPLAYFRAME_API FGSScopedAbilityRPCMultiBatcher
+{
+	FGSScopedAbilityRPCMultiBatcher(UGSAbilitySystemComponent* InASC);
+	~FGSScopedAbilityRPCMultiBatcher();
+
+private:
+	TWeakObjectPtr<UGSAbilitySystemComponent> ASC;
+};
@@ -19,10 +19,8 @@ public:
 	UGSAbilitySystemGlobals();
 
 	/**
-	* Cache commonly used tags here. This has the benefit of one place to set the tag FName in case tag names change and
-	* the function call into UGSAbilitySystemGlobals::GSGet() is cheaper than calling FGameplayTag::RequestGameplayTag().
-	* Classes can access them by UGSAbilitySystemGlobals::GSGet().DeadTag
-	* We're not using this in this sample project (classes are manually caching in their constructors), but it's here as a reference.
+	* Copies of the native tags in VTGameplayTags, kept for Blueprint and existing callers.
+	* New C++ code should use VTGameplayTags directly.
 	*/
 
 	UPROPERTY()
@@ -37,6 +35,10 @@ public:
 	UPROPERTY()
 	FGameplayTag InteractingRemovalTag;
 
+	// FGSAmmoTypeRow table that decides which reserve ammo slot each ammo tag uses
+	UPROPERTY(config)
+	FSoftObjectPath AmmoTypeTableName;
+
 	static UGSAbilitySystemGlobals& GSGet()
 	{
 		return dynamic_cast<UGSAbilitySystemGlobals&>(Get());
@@ -46,4 +48,6 @@ public:
 	virtual FGameplayEffectContext* AllocGameplayEffectContext() const override;
 
 	virtual void InitGlobalTags() override;
+
+	virtual void InitGlobalData() override;
 };
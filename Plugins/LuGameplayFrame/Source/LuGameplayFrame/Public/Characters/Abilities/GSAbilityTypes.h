@@ -19,6 +19,36 @@ class UGSAbilitySystemComponent;
 class UGameplayEffect;
 class UGSTargetType;
 
+UENUM(BlueprintType)
+enum class EGSAbilityCostType : uint8
+{
+	// No native cost. Only the CostGameplayEffectClass and any GSCheckCost/GSApplyCost override apply.
+	None,
+	// Primary clip ammo of the weapon that granted the ability (its SourceObject)
+	WeaponClipAmmo,
+	// Reserve ammo attribute for AmmoTag in UGSAmmoAttributeSet. Server authoritative: only the server checks and spends it,
+	// use a CostGameplayEffectClass instead if the owning client needs to predict the spend.
+	ReserveAmmo
+};
+
+/**
+ * Cost checked and applied in C++ without calling into Blueprint
+ */
+USTRUCT(BlueprintType)
+struct FGSAbilityNativeCost
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Cost")
+	EGSAbilityCostType CostType = EGSAbilityCostType::None;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Cost", Meta = (Categories = "Weapon.Ammo", EditCondition = "CostType == EGSAbilityCostType::ReserveAmmo"))
+	FGameplayTag AmmoTag;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Cost", Meta = (ClampMin = 0))
+	int32 Amount = 1;
+};
+
 /**
  * 定义一个游戏效果列表、标签和目标信息的结构体
  * 这些容器在蓝图或资产中静态定义，然后在运行时转换为 Specs
@@ -64,13 +94,73 @@ public:
 	bool HasValidTargets() const;
 
 	/** Adds new targets to target data */
-	void AddTargets(const TArray<FGameplayAbilityTargetDataHandle>& TargetData, const TArray<FHitResult>& HitResults, const TArray<AActor*>& TargetActors);
+	void AddTargets(TArrayView<const FGameplayAbilityTargetDataHandle> TargetData, TArrayView<const FHitResult> HitResults, TArrayView<AActor* const> TargetActors);
 
 	/** Clears target data */
 	void ClearTargets();
 };
 
 
+/**
+ * Marks the start of one shot inside a coalesced fire stream payload. Every target data entry after it, up to the next
+ * marker, belongs to that shot. Carries no targets itself, but consumers must still go through
+ * UGSGameplayAbility::SplitFireStreamTargetData or they will treat the whole payload as one shot.
+ */
+USTRUCT(BlueprintType)
+struct FGSGameplayAbilityTargetData_ShotTime : public FGameplayAbilityTargetData
+{
+	GENERATED_BODY()
+
+public:
+	FGSGameplayAbilityTargetData_ShotTime() {}
+
+	/** Server world time, as estimated by the firing client (AGameStateBase::GetServerWorldTimeSeconds), when the shot was taken */
+	UPROPERTY()
+	float TimeStamp = 0.0f;
+
+	virtual UScriptStruct* GetScriptStruct() const override
+	{
+		return FGSGameplayAbilityTargetData_ShotTime::StaticStruct();
+	}
+
+	virtual FString ToString() const override
+	{
+		return TEXT("FGSGameplayAbilityTargetData_ShotTime");
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+	{
+		Ar << TimeStamp;
+		bOutSuccess = true;
+		return true;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FGSGameplayAbilityTargetData_ShotTime> : public TStructOpsTypeTraitsBase2<FGSGameplayAbilityTargetData_ShotTime>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/** One shot split back out of a coalesced fire stream payload */
+USTRUCT(BlueprintType)
+struct FGSFireStreamShot
+{
+	GENERATED_BODY()
+
+public:
+	FGSFireStreamShot() {}
+
+	UPROPERTY(BlueprintReadOnly, Category = FireStream)
+	float TimeStamp = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = FireStream)
+	FGameplayAbilityTargetDataHandle TargetData;
+};
+
 #define ACTOR_ROLE_FSTRING *(FindObject<UEnum>(nullptr, TEXT("/Script/Engine.ENetRole"), true)->GetNameStringByValue(GetLocalRole()))
 #define GET_ACTOR_ROLE_FSTRING(Actor) *(FindObject<UEnum>(nullptr, TEXT("/Script/Engine.ENetRole"), true)->GetNameStringByValue(Actor->GetLocalRole()))
 
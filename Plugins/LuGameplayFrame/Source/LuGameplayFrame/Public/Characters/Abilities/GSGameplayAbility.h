@@ -69,6 +69,13 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Ability")
 	bool bCannotActivateWhileInteracting;
 
+	// Frames to hold shots sent through SendTargetDataToServer before sending them to the server as one payload.
+	// 0 sends every shot on its own. Meant for full auto weapons whose shots predict nothing on the client; shots sent
+	// inside a prediction window still go out alone. Server side handlers of the target data must call
+	// SplitFireStreamTargetData, the payload holds several shots separated by FGSGameplayAbilityTargetData_ShotTime.
+	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = "Ability", meta = (ClampMin = "0", ClampMax = "4"))
+	int32 FireStreamCoalesceFrames = 0;
+
 	// Map of gameplay tags to gameplay effect containers
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "GameplayEffects")
 	TMap<FGameplayTag, FGSGameplayEffectContainer> EffectContainerMap;
@@ -117,6 +124,10 @@ public:
 
 	virtual bool CanActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayTagContainer* SourceTags = nullptr, const FGameplayTagContainer* TargetTags = nullptr, OUT FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
 
+	// Evaluated in C++ by the default GSCheckCost/GSApplyCost, so abilities with simple ammo costs need no Blueprint override
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Costs")
+	FGSAbilityNativeCost NativeCost;
+
 	virtual bool CheckCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, OUT FGameplayTagContainer* OptionalRelevantTags = nullptr) const override;
 
 	// Allows C++ and Blueprint abilities to override how cost is checked in case they don't use a GE like weapon ammo
@@ -129,7 +140,7 @@ public:
 	// Allows C++ and Blueprint abilities to override how cost is applied in case they don't use a GE like weapon ammo
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Ability")
 	void GSApplyCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const;
-	virtual void GSApplyCost_Implementation(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const {};
+	virtual void GSApplyCost_Implementation(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo) const;
 
 	UFUNCTION(BlueprintCallable, Category = "Ability")
 	virtual void SetHUDReticle(TSubclassOf<class UGSHUDReticle> ReticleClass);
@@ -137,10 +148,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Ability")
 	virtual void ResetHUDReticle();
 
-	// Sends TargetData from the client to the Server and creates a new Prediction Window
+	// Sends TargetData from the client to the Server and creates a new Prediction Window.
+	// With FireStreamCoalesceFrames set, the shot is held and sent together with the following shots, unless it is
+	// sent inside a prediction window.
 	UFUNCTION(BlueprintCallable, Category = "Ability")
 	virtual void SendTargetDataToServer(const FGameplayAbilityTargetDataHandle& TargetData);
 
+	// Sends any shots held by SendTargetDataToServer now. Called automatically when the window closes and on EndAbility.
+	UFUNCTION(BlueprintCallable, Category = "Ability")
+	virtual void FlushFireStream();
+
+	// Splits target data received from the client into its shots, in the order they were fired.
+	// Required on the server for abilities with FireStreamCoalesceFrames set, reading the handle directly would treat
+	// the whole burst as one shot. Target data that was not coalesced comes back as a single shot with a TimeStamp of 0.
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Ability")
+	static TArray<FGSFireStreamShot> SplitFireStreamTargetData(const FGameplayAbilityTargetDataHandle& TargetData);
+
+	virtual void EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled) override;
+
 	// Is the player's input currently pressed? Only works if the ability is bound to input.
 	UFUNCTION(BlueprintCallable, Category = "Ability")
 	virtual bool IsInputPressed() const;
@@ -161,6 +186,26 @@ protected:
 	FGameplayTag InteractingTag;
 	FGameplayTag InteractingRemovalTag;
 
+	// SourceObject of our spec, cached when granted so instanced abilities don't search the ASC for it on every activation
+	TWeakObjectPtr<UObject> GrantedSourceObject;
+
+	// Set in the constructor. GSCheckCost/GSApplyCost only go through ProcessEvent when a Blueprint overrides them.
+	uint8 bHasBlueprintGSCheckCost : 1;
+	uint8 bHasBlueprintGSApplyCost : 1;
+
+	// Shots held by SendTargetDataToServer, each one led by a FGSGameplayAbilityTargetData_ShotTime
+	FGameplayAbilityTargetDataHandle PendingFireStreamData;
+	int32 PendingFireStreamShots = 0;
+	uint64 FireStreamStartFrame = 0;
+	bool bFireStreamTickScheduled = false;
+
+	int32 GetFireStreamCoalesceFrames() const;
+	void TickFireStream();
+	void CallServerSetTargetData(const FGameplayAbilityTargetDataHandle& TargetData);
+
+	bool CheckNativeCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo) const;
+	void ApplyNativeCost(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo& ActorInfo) const;
+
 
 	// ----------------------------------------------------------------------------------------------------------------
 	//	Animation Support for multiple USkeletalMeshComponents on the AvatarActor
@@ -12,6 +12,21 @@ class AVTCharacterBase;
 class AActor;
 struct FGameplayEventData;
 
+/** Caller-owned output of UGSTargetType::GatherTargets. Sized so a shotgun blast stays in the inline storage. */
+struct FGSTargetBuffers
+{
+	TArray<FGameplayAbilityTargetDataHandle, TInlineAllocator<2>> TargetData;
+	TArray<FHitResult, TInlineAllocator<12>> HitResults;
+	TArray<AActor*, TInlineAllocator<12>> Actors;
+
+	void Reset()
+	{
+		TargetData.Reset();
+		HitResults.Reset();
+		Actors.Reset();
+	}
+};
+
 
 /**
  * Target Class
@@ -22,12 +37,23 @@ class GASSHOOTER_API UGSTargetType : public UObject
 	GENERATED_BODY()
 
 public:
-	UGSTargetType() {}
+	UGSTargetType();
 
-	// 确定GE的对象
+	// 确定GE的对象。Goes through the Blueprint event only when a Blueprint overrides GetTargets
+	void CollectTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const;
+
+	// Native targeting. C++ subclasses override this instead of GetTargets_Implementation
+	virtual void GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const;
+
+	// 确定GE的对象。Blueprint only, CollectTargets never calls a native override.
 	UFUNCTION(BlueprintNativeEvent)
 	void GetTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const;
-	virtual void GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const;
+	// Final so C++ subclasses that still override it fail to compile instead of being silently skipped. Override GatherTargets.
+	virtual void GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const final;
+
+protected:
+	// Set in the constructor so native target types never go through ProcessEvent
+	uint8 bHasBlueprintGetTargets : 1;
 };
 
 /** Trivial Target：使用Owner */
@@ -39,7 +65,7 @@ class GASSHOOTER_API UGSTargetType_UseOwner : public UGSTargetType
 public:
 	UGSTargetType_UseOwner() {}
 	
-	virtual void GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+	virtual void GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const override;
 };
 
 /** Event Trivial Target：从Event Data获取Target */
@@ -51,5 +77,17 @@ class GASSHOOTER_API UGSTargetType_UseEventData : public UGSTargetType
 public:
 	UGSTargetType_UseEventData() {}
 
-	virtual void GetTargets_Implementation(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, FGameplayEventData EventData, TArray<FGameplayAbilityTargetDataHandle>& OutTargetData, TArray<FHitResult>& OutHitResults, TArray<AActor*>& OutActors) const override;
+	virtual void GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const override;
+};
+
+/** Event Target Data：从Event Data的TargetData获取Target, e.g. one hit per shotgun pellet */
+UCLASS(NotBlueprintable)
+class GASSHOOTER_API UGSTargetType_UseEventTargetData : public UGSTargetType
+{
+	GENERATED_BODY()
+
+public:
+	UGSTargetType_UseEventTargetData() {}
+
+	virtual void GatherTargets(AVTCharacterBase* TargetingCharacter, AActor* TargetingActor, const FGameplayEventData& EventData, FGSTargetBuffers& OutTargets) const override;
 };
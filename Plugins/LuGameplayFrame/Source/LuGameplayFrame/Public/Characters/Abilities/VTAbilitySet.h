@@ -0,0 +1,138 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GameplayAbilitySpecHandle.h"
+#include "ActiveGameplayEffectHandle.h"
+#include "VTAbilitySet.generated.h"
+
+class UAbilitySystemComponent;
+class UAttributeSet;
+class UDataTable;
+class UGameplayEffect;
+class UGSAbilitySystemComponent;
+class UGSGameplayAbility;
+
+USTRUCT(BlueprintType)
+struct LUGAMEPLAYFRAME_API FVTAbilitySet_GameplayAbility
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly)
+	TSubclassOf<UGSGameplayAbility> Ability;
+
+	UPROPERTY(EditDefaultsOnly)
+	int32 AbilityLevel = 1;
+};
+
+USTRUCT(BlueprintType)
+struct LUGAMEPLAYFRAME_API FVTAbilitySet_GameplayEffect
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly)
+	TSubclassOf<UGameplayEffect> GameplayEffect;
+
+	UPROPERTY(EditDefaultsOnly)
+	float EffectLevel = 1.0f;
+};
+
+USTRUCT(BlueprintType)
+struct LUGAMEPLAYFRAME_API FVTAbilitySet_AttributeSet
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly)
+	TSubclassOf<UAttributeSet> AttributeSet;
+
+	// Optional AttributeMetaData table the new set is initialized from
+	UPROPERTY(EditDefaultsOnly)
+	UDataTable* DefaultStartingTable = nullptr;
+};
+
+USTRUCT()
+struct LUGAMEPLAYFRAME_API FVTAbilitySet_GrantedAttributeSet
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UAttributeSet* AttributeSet = nullptr;
+
+	// Base values the set was created with, in property order. Put back when the set is reused.
+	TArray<float> StartingValues;
+};
+
+/**
+* Everything one UVTAbilitySet grant gave an ASC, so it can be taken back without searching the ASC.
+*/
+USTRUCT(BlueprintType)
+struct LUGAMEPLAYFRAME_API FVTAbilitySetGrantedHandles
+{
+	GENERATED_BODY()
+
+	void AddAbilitySpecHandles(const TArray<FGameplayAbilitySpecHandle>& Handles);
+	void AddGameplayEffectHandle(const FActiveGameplayEffectHandle& Handle);
+	void AddAttributeSet(UAttributeSet* AttributeSet);
+
+	/**
+	* Server only. Clears the abilities in one batch, removes the effects and attribute sets, then empties the handles.
+	* With bKeepAttributeSets the attribute sets stay on the ASC for the next grant to reuse, e.g. for a round reset.
+	*/
+	void TakeFromAbilitySystem(UGSAbilitySystemComponent* ASC, bool bKeepAttributeSets = false);
+
+	// Takes back a kept set of exactly this class with its starting values restored. False if there is none.
+	bool ReuseKeptAttributeSet(UGSAbilitySystemComponent* ASC, TSubclassOf<UAttributeSet> AttributeSetClass);
+
+	// Removes the kept sets that no grant reused
+	void RemoveKeptAttributeSets(UGSAbilitySystemComponent* ASC);
+
+	bool IsEmpty() const;
+
+protected:
+	UPROPERTY()
+	TArray<FGameplayAbilitySpecHandle> AbilitySpecHandles;
+
+	UPROPERTY()
+	TArray<FActiveGameplayEffectHandle> GameplayEffectHandles;
+
+	UPROPERTY()
+	TArray<FVTAbilitySet_GrantedAttributeSet> GrantedAttributeSets;
+
+	// Still registered with the ASC, waiting to be reused
+	UPROPERTY()
+	TArray<FVTAbilitySet_GrantedAttributeSet> KeptAttributeSets;
+};
+
+/**
+* Abilities, effects and attribute sets granted and revoked as a unit. Used for character loadouts and weapon pickups.
+*/
+UCLASS(BlueprintType, Const)
+class LUGAMEPLAYFRAME_API UVTAbilitySet : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Server only. Grants the whole set to ASC. Abilities go in with a single MarkArrayDirty and effects are applied
+	* from the shared spec templates. Handles are appended to OutGrantedHandles when it is given.
+	*/
+	void GiveToAbilitySystem(UGSAbilitySystemComponent* ASC, FVTAbilitySetGrantedHandles* OutGrantedHandles, UObject* SourceObject = nullptr) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Abilities", Meta = (DisplayName = "GiveToAbilitySystem"))
+	FVTAbilitySetGrantedHandles K2_GiveToAbilitySystem(UAbilitySystemComponent* ASC, UObject* SourceObject) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Abilities", Meta = (DisplayName = "TakeFromAbilitySystem"))
+	static void K2_TakeFromAbilitySystem(UAbilitySystemComponent* ASC, UPARAM(ref) FVTAbilitySetGrantedHandles& GrantedHandles);
+
+protected:
+	UPROPERTY(EditDefaultsOnly, Category = "Abilities", Meta = (TitleProperty = Ability))
+	TArray<FVTAbilitySet_GameplayAbility> GrantedGameplayAbilities;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Abilities", Meta = (TitleProperty = GameplayEffect))
+	TArray<FVTAbilitySet_GameplayEffect> GrantedGameplayEffects;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Abilities", Meta = (TitleProperty = AttributeSet))
+	TArray<FVTAbilitySet_AttributeSet> GrantedAttributes;
+};
@@ -0,0 +1,54 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffect.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "VTEffectSpecTemplateSubsystem.generated.h"
+
+/**
+ * Specs for startup GameplayEffects, built once per (effect class, level) and shared by every character.
+ * Emptied on world cleanup, and when an effect class is recompiled or reloaded, so templates never outlive their CDO.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTEffectSpecTemplateSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	static void AddReferencedObjects(UObject* InThis, FReferenceCollector& Collector);
+
+	/**
+	* Spec for GameplayEffect at Level with no context. Copy it, then give the copy a context and source capture.
+	* Used for DefaultAttributes, StartupEffects and ability set effects. Builds an uncached spec if the subsystem is gone.
+	*/
+	static TSharedPtr<const FGameplayEffectSpec> GetEffectSpecTemplate(TSubclassOf<UGameplayEffect> GameplayEffect, float Level);
+
+	void ClearTemplates();
+
+protected:
+	struct FEffectSpecTemplate
+	{
+		// Keeps the class, and so the CDO the spec's Def points at, alive
+		TObjectPtr<UClass> EffectClass;
+		TSharedPtr<const FGameplayEffectSpec> Spec;
+	};
+
+	TMap<TPair<FObjectKey, float>, FEffectSpecTemplate> EffectSpecTemplates;
+
+	FDelegateHandle WorldCleanupHandle;
+	FDelegateHandle ObjectsReplacedHandle;
+	FDelegateHandle ReinstancingCompleteHandle;
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+#if WITH_EDITOR
+	// Blueprint recompiles replace the effect class and its CDO
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+#endif
+};
@@ -36,11 +36,86 @@ class GASSHOOTER_API UGSCharacterMovementComponent : public UCharacterMovementCo
 		///@brief Sets variables on character movement component before making a predictive correction.
 		virtual void PrepMoveFor(class ACharacter* Character) override;
 
+		///@brief Restores the sprint stamina of the pending move before it is combined into this one.
+		virtual void CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) override;
+
+		///@brief Moves that carry ability input edges are resent until acked so no press or release is lost.
+		virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override;
+
+		///@brief Captures the sprint stamina at the end of the move so it can be sent to the server.
+		virtual void PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode) override;
+
 		// Sprint
 		uint8 SavedRequestToStartSprinting : 1;
 
 		// Aim Down Sights
 		uint8 SavedRequestToStartADS : 1;
+
+		// UGSAbilitySystemComponent::GetLocalAbilityInputMask when the move was made
+		uint16 SavedAbilityInputMask;
+
+		// Ability input edges that happened during this move, see UGSAbilitySystemComponent::ConsumeLocalAbilityInputEdges
+		uint16 SavedAbilityInputPressedEdges;
+		uint16 SavedAbilityInputReleasedEdges;
+
+		bool HasAbilityInputEdges() const { return (SavedAbilityInputPressedEdges | SavedAbilityInputReleasedEdges) != 0; }
+
+		// Sprint stamina before and after this move was simulated
+		uint8 SavedSprintExhausted : 1;
+		float SavedStartSprintStamina;
+		float SavedEndSprintStamina;
+	};
+
+	/** Move data sent to the server. Carries the client's predicted sprint stamina so the server can detect a mismatch. */
+	struct FGSCharacterNetworkMoveData : public FCharacterNetworkMoveData
+	{
+	public:
+
+		typedef FCharacterNetworkMoveData Super;
+
+		FGSCharacterNetworkMoveData() : SprintStamina(0.0f), AbilityInputMask(0), AbilityInputPressedEdges(0), AbilityInputReleasedEdges(0)
+		{
+		}
+
+		virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+		virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+
+		// Sent as tenths of a point
+		float SprintStamina;
+
+		// Pressed ability inputs at the end of the move. Orders a press and release that share a move.
+		uint16 AbilityInputMask;
+
+		// Press and release edges for active bReplicateInputDirectly specs during the move. Sent with the mask only when
+		// the move has an edge, one bit per InputID up to the highest one with an edge.
+		uint16 AbilityInputPressedEdges;
+		uint16 AbilityInputReleasedEdges;
+	};
+
+	struct FGSCharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+	{
+	public:
+		FGSCharacterNetworkMoveDataContainer();
+
+		FGSCharacterNetworkMoveData MoveData[3];
+	};
+
+	/** Correction sent back to the client. Carries the server's sprint stamina so the client replays from the same state. */
+	struct FGSCharacterMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+	{
+	public:
+
+		typedef FCharacterMoveResponseDataContainer Super;
+
+		FGSCharacterMoveResponseDataContainer() : SprintStamina(0.0f), bSprintExhausted(false)
+		{
+		}
+
+		virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+		virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+
+		float SprintStamina;
+		bool bSprintExhausted;
 	};
 
 	class FGSNetworkPredictionData_Client : public FNetworkPredictionData_Client_Character
@@ -66,9 +141,31 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speed")
 	float KnockedDownSpeedMultiplier;
 
+	// Stamina drained per second while sprinting. Simulated inside the move so client and server agree on when sprint stops.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sprint")
+	float SprintStaminaCostPerSecond;
+
+	// After running out of stamina, sprinting is blocked until stamina has regenerated back to this value.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sprint")
+	float SprintStaminaRecoverThreshold;
+
+	// Client and server stamina may differ by this much before the server sends a correction.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sprint")
+	float SprintStaminaErrorTolerance;
+
+	// How often (seconds) the server writes the predicted stamina back into the Stamina attribute.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sprint")
+	float StaminaReconcileInterval;
+
 	uint8 RequestToStartSprinting : 1;
 	uint8 RequestToStartADS : 1;
 
+	// Set when stamina hits zero while sprinting. Cleared once stamina reaches SprintStaminaRecoverThreshold.
+	uint8 bSprintExhausted : 1;
+
+	// Stamina as simulated by the movement component. Negative until seeded from the Stamina attribute.
+	float SprintStamina;
+
 	FGameplayTag KnockedDownTag;
 	FGameplayTag InteractingTag;
 	FGameplayTag InteractingRemovalTag;
@@ -76,6 +173,9 @@ public:
 	virtual float GetMaxSpeed() const override;
 	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
 	virtual class FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
 
 	// Sprint
 	UFUNCTION(BlueprintCallable, Category = "Sprint")
@@ -83,9 +183,41 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Sprint")
 	void StopSprinting();
 
+	// True if sprint is requested and there is stamina left to sprint
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Sprint")
+	bool IsSprinting() const;
+
+	// Predicted stamina. Use this instead of the Stamina attribute for UI that needs to be in sync with sprinting.
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "Sprint")
+	float GetPredictedStamina() const;
+
+	// True once the movement component has taken over Stamina drain and regen from gameplay effects
+	bool IsSimulatingStamina() const { return SprintStamina >= 0.0f; }
+
 	// Aim Down Sights
 	UFUNCTION(BlueprintCallable, Category = "Aim Down Sights")
 	void StartAimDownSights();
 	UFUNCTION(BlueprintCallable, Category = "Aim Down Sights")
 	void StopAimDownSights();
+
+protected:
+	FGSCharacterNetworkMoveDataContainer GSNetworkMoveDataContainer;
+	FGSCharacterMoveResponseDataContainer GSMoveResponseDataContainer;
+
+	// Client timestamp of the last move whose ability input edges were applied, so resent moves aren't applied twice
+	float LastAbilityInputMaskTimeStamp;
+
+	virtual void ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData) override;
+
+	// Time since the server last wrote SprintStamina into the Stamina attribute
+	float TimeSinceStaminaReconcile;
+
+	// Stamina attribute value the server last wrote. Any other value means a GE changed it.
+	float LastReconciledStamina;
+
+	// Drains or regenerates SprintStamina for one simulated move. Deterministic for a given input and start state.
+	void TickSprintStamina(float DeltaSeconds);
+
+	// Server only. Low frequency sync between SprintStamina and the Stamina attribute.
+	void ReconcileStaminaAttribute(float DeltaSeconds);
 };
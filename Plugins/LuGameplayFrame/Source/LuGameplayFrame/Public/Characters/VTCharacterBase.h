@@ -5,8 +5,12 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "AbilitySystemInterface.h"
+#include "GenericTeamAgentInterface.h"
 #include "GameplayTagContainer.h"
 #include "TimerManager.h"
+#include "Characters/VTSignificanceSubsystem.h"
+#include "Characters/Abilities/GSAbilitySystemComponent.h"
+#include "Characters/Abilities/VTAbilitySet.h"
 
 #include "VTCharacterBase.generated.h"
 
@@ -33,7 +37,7 @@ struct LUGAMEPLAYFRAME_API FVTDamageNumber
 
 
 UCLASS()
-class LUGAMEPLAYFRAME_API AVTCharacterBase : public ACharacter, public IAbilitySystemInterface
+class LUGAMEPLAYFRAME_API AVTCharacterBase : public ACharacter, public IAbilitySystemInterface, public IGenericTeamAgentInterface
 {
 	GENERATED_BODY()
 
@@ -42,6 +46,19 @@ public:
 
 	virtual class UAbilitySystemComponent* GetAbilitySystemComponent() const override;
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void PossessedBy(AController* NewController) override;
+
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
+	// Montage state of an ASC that lives on another actor (the PlayerState), as last replicated with this character
+	const TArray<FGameplayAbilityRepAnimMontageForMesh>& GetAbilityMontageInfoForMeshes() const { return AbilityMontageInfoForMeshes; }
+
+	// Team used by UVTReplicationGraph to keep teammates relevant. Set on the server, usually by the game mode.
+	virtual void SetGenericTeamId(const FGenericTeamId& NewTeamId) override;
+	virtual FGenericTeamId GetGenericTeamId() const override { return TeamId; }
+
 	/**
 	 * 
 	 * @return 
@@ -51,8 +68,9 @@ public:
 
 	/**
 	 * Can only be called by the Server. 清除所有GA
+	 * bKeepAttributeSets leaves ability set attribute sets on the ASC for the next AddCharacterAbilities to reuse.
 	 */
-	virtual void RemoveCharacterAbilities();
+	virtual void RemoveCharacterAbilities(bool bKeepAttributeSets = false);
 
 	/**
 	 * 
@@ -65,6 +83,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "GASShooter|GSCharacter")
 	virtual void FinishDying();
 
+	/**
+	 * Server only. Hides, unpossesses and puts the character to sleep so UVTCharacterPoolSubsystem can reuse it.
+	 */
+	virtual void DeactivateForPool();
+
+	/**
+	 * Server only. Brings a pooled character back at SpawnTransform with fresh movement, tags, montages and attributes.
+	 */
+	virtual void ReactivateFromPool(const FTransform& SpawnTransform);
+
+	bool IsPooled() const { return bIsPooled; }
+
+	/**
+	 * Server only. Start of round reset used by UVTRoundResetSubsystem: revives, clears effects/tags/montages,
+	 * restores DefaultAttributes and StartupEffects and refills reserve ammo. Doesn't move the character.
+	 */
+	virtual void ResetForRound();
+
 	/**
 	 * 
 	 * @param Damage 
@@ -80,6 +116,30 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "GASShooter|GSCharacter")
 	FVTCharacterDiedDelegate OnCharacterDied;
 
+	/**
+	* Client side significance. Set by UVTSignificanceSubsystem, scales how often this character is updated locally.
+	**/
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "GASShooter|GSCharacter|Significance")
+	EVTSignificanceTier GetSignificanceTier() const { return SignificanceTier; }
+
+	virtual void SetSignificanceTier(EVTSignificanceTier NewTier);
+
+	// Seconds between floating status bar refreshes for the current tier. 0 is every frame, negative is never.
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "GASShooter|GSCharacter|Significance")
+	float GetFloatingStatusBarUpdateInterval() const { return FloatingStatusBarUpdateInterval; }
+
+	// Marks this character as fighting so it keeps a higher significance for a short time
+	void NotifyCombatActivity();
+
+	float GetLastCombatTime() const { return LastCombatTime; }
+
+	const TSoftClassPtr<class UVTDamageTextWidgetComponent>& GetDamageNumberClass() const { return DamageNumberClass; }
+
+	// Attribute values for the HUD and floating status bar, batched per frame. Null until the character has an ASC.
+	UFUNCTION(BlueprintCallable, Category = "GASShooter|GSCharacter|UI")
+	class UVTAttributeViewModel* GetAttributeViewModel();
+
 	/**
 	* Getters for attributes from GSAttributeSetBase
 	**/
@@ -120,12 +180,32 @@ public:
 	float GetMoveSpeedBaseValue() const;
 
 protected:
+	// NoTeam until the game mode or the possessing controller assigns one
+	UPROPERTY(EditAnywhere, Replicated, Category = "GASShooter|GSCharacter")
+	FGenericTeamId TeamId;
+
 	FGameplayTag DeadTag;
 	FGameplayTag EffectRemoveOnDeathTag;
 
+	// Ring buffer of numbers waiting to be shown, so they don't all pop up on the same frame
+	static constexpr int32 DamageNumberQueueCapacity = 8;
 	TArray<FVTDamageNumber> DamageNumberQueue;
+	int32 DamageNumberQueueHead;
+	int32 DamageNumberQueueNum;
 	FTimerHandle DamageNumberTimer;
 
+	// Most recent number on screen. Hits right after it add to it instead of showing another one.
+	TWeakObjectPtr<class UVTDamageTextWidgetComponent> LastDamageText;
+
+	EVTSignificanceTier SignificanceTier;
+	float FloatingStatusBarUpdateInterval;
+	float LastCombatTime;
+
+	bool bIsPooled;
+
+	// Smoothing mode from the Blueprint, restored when the character goes back to High significance
+	ENetworkSmoothingMode DefaultNetworkSmoothingMode;
+
 	// Reference to the ASC. It will live on the PlayerState or here if the character doesn't have a PlayerState.
 	UPROPERTY()
 	class UGSAbilitySystemComponent* AbilitySystemComponent;
@@ -134,6 +214,9 @@ protected:
 	UPROPERTY()
 	class UGSAttributeSetBase* AttributeSetBase;
 
+	UPROPERTY()
+	class UVTAttributeViewModel* AttributeViewModel;
+
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "GASShooter|GSCharacter")
 	FText CharacterName;
 
@@ -147,6 +230,14 @@ protected:
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "GASShooter|Abilities")
 	TArray<TSubclassOf<class UGSGameplayAbility>> CharacterAbilities;
 
+	// Granted and removed together with CharacterAbilities
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "GASShooter|Abilities")
+	TArray<UVTAbilitySet*> AbilitySets;
+
+	// What AddCharacterAbilities granted, so RemoveCharacterAbilities doesn't have to search the ASC
+	UPROPERTY()
+	FVTAbilitySetGrantedHandles CharacterAbilityHandles;
+
 	// Default attributes for a character for initializing on spawn/respawn.
 	// This is an instant GE that overrides the values for attributes that get reset on spawn/respawn.
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "GASShooter|Abilities")
@@ -156,12 +247,23 @@ protected:
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "GASShooter|Abilities")
 	TArray<TSubclassOf<class UGameplayEffect>> StartupEffects;
 
+	// Soft so dedicated servers never load it. Clients load it asynchronously through UVTDamageNumberPoolSubsystem.
 	UPROPERTY(EditAnywhere, Category = "GASShooter|UI")
-	TSubclassOf<class UVTDamageTextWidgetComponent> DamageNumberClass;
+	TSoftClassPtr<class UVTDamageTextWidgetComponent> DamageNumberClass;
+
+	// Replicated here instead of on the ASC when the ASC is on the always relevant PlayerState, so the replication graph
+	// culls an enemy's montages per connection together with the character
+	UPROPERTY(ReplicatedUsing = OnRep_AbilityMontageInfoForMeshes)
+	TArray<FGameplayAbilityRepAnimMontageForMesh> AbilityMontageInfoForMeshes;
+
+	UFUNCTION()
+	virtual void OnRep_AbilityMontageInfoForMeshes();
 
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Grant abilities on the Server. The Ability Specs will be replicated to the owning client.
 	virtual void AddCharacterAbilities();
 
@@ -172,6 +274,15 @@ protected:
 
 	virtual void AddStartupEffects();
 
+	// InitializeAttributes and AddStartupEffects together, with attribute aggregation and replication done once at the end
+	virtual void ApplySpawnEffects();
+
+	// Applies a copy of the shared spec template for GameplayEffect to our ASC
+	FActiveGameplayEffectHandle ApplyEffectFromTemplate(TSubclassOf<class UGameplayEffect> GameplayEffect, const FGameplayEffectContextHandle& EffectContext);
+
+	// Undoes Die() and gives the ASC its starting state back. Shared by pooling and round reset.
+	virtual void RestoreSpawnState();
+
 	virtual void ShowDamageNumber();
 
 
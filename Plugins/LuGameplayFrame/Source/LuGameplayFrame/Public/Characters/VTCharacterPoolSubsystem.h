@@ -0,0 +1,41 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "VTCharacterPoolSubsystem.generated.h"
+
+class AVTCharacterBase;
+
+/**
+ * Server side pool of dead characters. FinishDying hands characters here instead of destroying them, and respawning
+ * takes one back out, skipping the spawn and component registration of a whole character with its ASC and meshes.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTCharacterPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	// Reuses a pooled character of exactly CharacterClass or spawns a new one. The caller possesses it.
+	UFUNCTION(BlueprintCallable, Category = "GASShooter|GSCharacter")
+	AVTCharacterBase* AcquireCharacter(TSubclassOf<AVTCharacterBase> CharacterClass, const FTransform& SpawnTransform, AActor* Owner = nullptr);
+
+	// Deactivates Character and keeps it for reuse. Returns false if the pool is full or disabled, or nothing ever
+	// acquires this class through the pool (it would never be reused), then the caller destroys it.
+	bool ReleaseCharacter(AVTCharacterBase* Character);
+
+	static bool IsPoolingEnabled();
+
+protected:
+	UPROPERTY()
+	TArray<AVTCharacterBase*> PooledCharacters;
+
+	// Classes something has asked AcquireCharacter for, i.e. the game mode's pawn classes
+	TSet<TObjectKey<UClass>> AcquiredClasses;
+};
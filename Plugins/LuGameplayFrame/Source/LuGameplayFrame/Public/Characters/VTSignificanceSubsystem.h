@@ -0,0 +1,56 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VTSignificanceSubsystem.generated.h"
+
+class AVTCharacterBase;
+
+/**
+ * How much work a remote character is worth on this client. Ordered from most to least significant.
+ */
+UENUM(BlueprintType)
+enum class EVTSignificanceTier : uint8
+{
+	// Close, on screen or in a fight. Full rate everything.
+	High				UMETA(DisplayName = "High"),
+	// Mid range or off screen. Reduced animation and UI rate.
+	Medium				UMETA(DisplayName = "Medium"),
+	// Far away. Minimal animation, no movement smoothing.
+	Low					UMETA(DisplayName = "Low"),
+	// Not worth updating except for gameplay.
+	Off					UMETA(DisplayName = "Off")
+};
+
+/**
+ * Ranks remote AVTCharacterBase per local player through the SignificanceManager and scales their client side update
+ * rates (animation, movement smoothing, floating status bar) from that rank.
+ * Only runs on clients. The server side of update rates is handled by replication, not here.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Called by characters in BeginPlay/EndPlay
+	void RegisterCharacter(AVTCharacterBase* Character);
+	void UnregisterCharacter(AVTCharacterBase* Character);
+
+	static FName CharacterSignificanceTag;
+
+protected:
+	// Viewpoints of every local player, reused between frames
+	TArray<FTransform> Viewpoints;
+
+	// Higher is more significant. Combines distance, view angle and recent combat.
+	static float CalculateSignificance(const AVTCharacterBase* Character, const FTransform& Viewpoint);
+
+	static EVTSignificanceTier GetTierForSignificance(float Significance);
+};
@@ -0,0 +1,45 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VTActorPoolSubsystem.generated.h"
+
+/**
+ * Recycles short lived actors like projectiles. Released actors are hidden with collision and tick off until the next
+ * Acquire of the same class. Implement IVTPooledActorInterface for anything else that needs resetting.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Reuses a released actor of exactly ActorClass or spawns one with SpawnParams
+	AActor* AcquireActor(TSubclassOf<AActor> ActorClass, const FTransform& Transform, const FActorSpawnParameters& SpawnParams = FActorSpawnParameters());
+
+	template<class T>
+	T* AcquireActor(TSubclassOf<T> ActorClass, const FTransform& Transform, const FActorSpawnParameters& SpawnParams = FActorSpawnParameters())
+	{
+		return Cast<T>(AcquireActor(TSubclassOf<AActor>(ActorClass), Transform, SpawnParams));
+	}
+
+	// Returns Actor to the pool, or destroys it if the pool is full
+	void ReleaseActor(AActor* Actor);
+
+	// Returns every actor handed out by this pool. Used between rounds.
+	void ReleaseAllActors();
+
+	// Static helper for actors that may or may not have come from a pool
+	static bool ReleaseToPool(AActor* Actor);
+
+protected:
+	UPROPERTY()
+	TArray<AActor*> ActiveActors;
+
+	UPROPERTY()
+	TArray<AActor*> FreeActors;
+};
@@ -0,0 +1,28 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "VTPooledActorInterface.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UVTPooledActorInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Optional hooks for actors recycled by UVTActorPoolSubsystem. The pool already handles visibility, collision and tick.
+ */
+class LUGAMEPLAYFRAME_API IVTPooledActorInterface
+{
+	GENERATED_BODY()
+
+public:
+	// After the actor was moved to its new transform
+	virtual void OnAcquiredFromPool() {}
+
+	// Stop anything still running, e.g. movement and timers
+	virtual void OnReleasedToPool() {}
+};
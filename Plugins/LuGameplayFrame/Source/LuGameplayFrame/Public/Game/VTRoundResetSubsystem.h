@@ -0,0 +1,33 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VTRoundResetSubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FVTOnRoundReset, UWorld*);
+
+/**
+ * Resets a round in one frame without reloading the level. Every AVTCharacterBase goes back to its spawn state
+ * (attributes, startup effects, tags, abilities, ammo) and every pooled actor such as projectiles is returned.
+ * Game code that needs to reset its own actors can bind OnRoundReset. Server only.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTRoundResetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	UFUNCTION(BlueprintCallable, Category = "GASShooter|Round")
+	void ResetRound();
+
+	// Broadcast at the end of ResetRound
+	FVTOnRoundReset OnRoundReset;
+
+protected:
+	// Live UObject count after the previous reset, for spotting leaks between rounds
+	int32 LastObjectCount = 0;
+};
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("LuGameplayFrame"), STATGROUP_LuGameplayFrame, STATCAT_Advanced);
 
 class FLuGameplayFrameModule : public IModuleInterface
 {
@@ -0,0 +1,122 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "VTReplicationGraph.generated.h"
+
+class AVTCharacterBase;
+class UVTReplicationGraphNode_FogOfWar;
+
+/**
+ * Which graph node an actor class is routed to
+ */
+UENUM()
+enum class EVTClassRepNodeMapping : uint8
+{
+	// Not routed to any node. Owner only actors that replicate through their owner.
+	NotRouted,
+	// Replicated to every connection
+	RelevantAllConnections,
+	// Spatialized and never moves
+	Spatialize_Static,
+	// Spatialized and moves every frame (characters, projectiles)
+	Spatialize_Dynamic,
+	// Spatialized and goes dormant when not changing (pickups)
+	Spatialize_Dormancy
+};
+
+USTRUCT()
+struct FVTRepGraphClassSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FSoftClassPath ActorClass;
+
+	UPROPERTY(EditAnywhere)
+	EVTClassRepNodeMapping NodeMapping = EVTClassRepNodeMapping::NotRouted;
+};
+
+/**
+ * Project replication graph. Characters and projectiles are in a spatial grid, teammates are always relevant to each
+ * other, dormant actors like pickups only cost something when they wake up.
+ * Enabled with VT.RepGraph.Enable, otherwise the engine's default relevancy is used.
+ * With VT.FogOfWar.Enable, enemy characters go through UVTReplicationGraphNode_FogOfWar instead of the grid.
+ */
+UCLASS(Transient, Config = Engine)
+class LUGAMEPLAYFRAME_API UVTReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UVTReplicationGraph();
+
+	virtual void ResetGameWorldState() override;
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+
+	// Characters on the given team, rebuilt every replication frame
+	FActorRepListRefView* GetTeamActorList(uint8 TeamId);
+
+	// Team of an actor, its controller or its player state. FGenericTeamId::NoTeam if none.
+	static uint8 GetTeamForActor(const AActor* Actor);
+
+	// Class overrides, i.e. to spatialize the game module's projectile class
+	UPROPERTY(Config)
+	TArray<FVTRepGraphClassSettings> ClassSettings;
+
+	UPROPERTY(Config)
+	float SpatialGridCellSize;
+
+	// Bias the grid so the whole map is in positive cell space
+	UPROPERTY(Config)
+	FVector2D SpatialGridBias;
+
+	// Default cull distance for spatialized classes that don't set their own
+	UPROPERTY(Config)
+	float DefaultCullDistance;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	// Only created when fog of war is enabled
+	UPROPERTY()
+	UVTReplicationGraphNode_FogOfWar* FogOfWarNode;
+
+protected:
+	TClassMap<EVTClassRepNodeMapping> ClassRepNodePolicies;
+
+	// Every character, used to rebuild TeamActorLists
+	FActorRepListRefView AllCharacters;
+
+	TMap<uint8, FActorRepListRefView> TeamActorLists;
+
+	EVTClassRepNodeMapping GetMappingPolicy(const UClass* Class);
+	EVTClassRepNodeMapping GetDefaultMappingPolicy(const UClass* Class) const;
+
+	void RebuildTeamActorLists();
+};
+
+/**
+ * Adds the characters of the viewer's team to the connection's gather list
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTReplicationGraphNode_AlwaysRelevant_ForTeam : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& Actor) override {}
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override {}
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+};
@@ -0,0 +1,99 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "VTReplicationGraphNode_FogOfWar.generated.h"
+
+/**
+ * Server side line of sight state for one (viewer, enemy) pair
+ */
+struct FVTFogOfWarPair
+{
+	// Raw (viewer, target) pointers, only used as the PairIndices key
+	TPair<AActor*, AActor*> Key;
+
+	TWeakObjectPtr<AActor> Viewer;
+	TWeakObjectPtr<AActor> Target;
+
+	// Last view location of the viewer's connection, traces start here
+	FVector ViewLocation = FVector::ZeroVector;
+
+	// World time of the last trace that saw the target. Pairs start visible so nothing pops in late.
+	double LastVisibleTime = 0.0;
+
+	// World time this pair was last asked for by a connection. Unused pairs get dropped.
+	double LastQueriedTime = 0.0;
+};
+
+/**
+ * Replaces the spatial grid for characters when fog of war is on. Enemy characters are only gathered for a connection
+ * when a recent line of sight trace from the viewer could see them, so hidden enemies don't replicate movement or montages.
+ * Traces are amortized across frames with a fixed budget and a grace window keeps enemies relevant for a moment after
+ * losing sight. Teammates and the viewer's own pawn are handled by other nodes.
+ * This global node owns the characters and the trace state, UVTReplicationGraphNode_FogOfWar_ForConnection gathers.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTReplicationGraphNode_FogOfWar : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UVTReplicationGraphNode_FogOfWar();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override {}
+
+	// Adds the enemies the connection's viewers can currently see to OutList
+	void GatherVisibleEnemies(const FConnectionGatherActorListParameters& Params, FActorRepListRefView& OutList);
+
+protected:
+	FActorRepListRefView Characters;
+
+	TArray<FVTFogOfWarPair> Pairs;
+	TMap<TPair<AActor*, AActor*>, int32> PairIndices;
+
+	// Round robin position in Pairs for the trace budget
+	int32 NextPairToTrace;
+
+	// Metrics, logged once per second with VT.FogOfWar.LogStats
+	int32 TracesThisSecond;
+	int32 CulledThisSecond;
+	double StatsWindowStart;
+
+	// VT.FogOfWar.EstimatedBytesPerUpdate for every culled gather that would have sent an update
+	double BytesSavedThisSecond;
+
+	FVTFogOfWarPair& FindOrAddPair(AActor* Viewer, AActor* Target, double Now);
+
+	// Conservative test: visible if any of a few points around the (extrapolated) target can be seen
+	bool TracePair(UWorld* World, const FVTFogOfWarPair& Pair);
+
+	void RemovePairAt(int32 Index);
+};
+
+/**
+ * Per connection side of UVTReplicationGraphNode_FogOfWar. Owns the list handed to the connection, so it stays put for
+ * the whole replication frame and goes away with the connection.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTReplicationGraphNode_FogOfWar_ForConnection : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override {}
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override { return false; }
+	virtual void NotifyResetAllNetworkActors() override { VisibleEnemies.Reset(); }
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	UPROPERTY()
+	UVTReplicationGraphNode_FogOfWar* FogOfWarNode = nullptr;
+
+protected:
+	FActorRepListRefView VisibleEnemies;
+};
@@ -0,0 +1,77 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "GameplayTagContainer.h"
+#include "VTDamageNumberBatchComponent.generated.h"
+
+/**
+ * One target's damage for a frame. Target goes over the wire as its NetGUID and damage as packed tenths.
+ */
+USTRUCT()
+struct LUGAMEPLAYFRAME_API FVTDamageNumberBatchEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	AActor* Target = nullptr;
+
+	// Damage * 10, rounded
+	uint32 QuantizedDamage = 0;
+
+	FGameplayTagContainer Tags;
+
+	float GetDamage() const { return QuantizedDamage * 0.1f; }
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FVTDamageNumberBatchEntry> : public TStructOpsTypeTraitsBase2<FVTDamageNumberBatchEntry>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ * Lives on the player controller. Collects the damage this player deals during a frame on the server, merges hits on
+ * the same target and sends the owning client one unreliable RPC per frame instead of one per bullet or pellet.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTDamageNumberBatchComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UVTDamageNumberBatchComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Server only. Queues a damage number for Controller's client, adding the batch component if needed.
+	static void QueueDamageNumber(AController* Controller, float Damage, AActor* Target, const FGameplayTagContainer& DamageNumberTags);
+
+	void AddDamageNumber(float Damage, AActor* Target, const FGameplayTagContainer& DamageNumberTags);
+
+protected:
+	struct FPendingDamageNumber
+	{
+		TWeakObjectPtr<AActor> Target;
+		float Damage;
+		FGameplayTagContainer Tags;
+	};
+
+	TArray<FPendingDamageNumber> PendingDamageNumbers;
+
+	// Reused every flush
+	TArray<FVTDamageNumberBatchEntry> OutgoingBatch;
+
+	void FlushDamageNumbers();
+
+	UFUNCTION(Client, Unreliable)
+	void ClientShowDamageNumbers(const TArray<FVTDamageNumberBatchEntry>& DamageNumbers);
+	void ClientShowDamageNumbers_Implementation(const TArray<FVTDamageNumberBatchEntry>& DamageNumbers);
+};
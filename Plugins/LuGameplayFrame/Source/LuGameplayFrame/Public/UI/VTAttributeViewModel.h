@@ -0,0 +1,163 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffectTypes.h"
+#include "UObject/Object.h"
+#include "VTAttributeViewModel.generated.h"
+
+class UAbilitySystemComponent;
+class UVTFloatingStatusBarWidget;
+class UVTHUDWidget;
+
+/**
+ * Which parts of FVTAttributeView changed since the last update
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EVTAttributeViewField : uint8
+{
+	None				= 0 UMETA(Hidden),
+	Health				= 1 << 0,
+	Mana				= 1 << 1,
+	Stamina				= 1 << 2,
+	Shield				= 1 << 3,
+	RegenRates			= 1 << 4,
+	Experience			= 1 << 5,
+	Gold				= 1 << 6,
+	CharacterLevel		= 1 << 7
+};
+ENUM_CLASS_FLAGS(EVTAttributeViewField);
+
+/**
+ * Everything the HUD and floating status bars show about a character's attributes, percentages already worked out
+ */
+USTRUCT(BlueprintType)
+struct LUGAMEPLAYFRAME_API FVTAttributeView
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	float Health = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxHealth = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float HealthPercentage = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float HealthRegenRate = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Mana = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxMana = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float ManaPercentage = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float ManaRegenRate = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Stamina = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxStamina = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float StaminaPercentage = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float StaminaRegenRate = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float Shield = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float MaxShield = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float ShieldPercentage = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	float ShieldRegenRate = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Experience = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Gold = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 CharacterLevel = 0;
+
+};
+
+/**
+ * Per character view of its attributes. Listens to the ASC's attribute change delegates, collects everything that
+ * changed during a frame and gives each widget one update on the next tick instead of a Blueprint call per setter.
+ * Floating status bars are handed to UVTFloatingStatusBarSubsystem, which pulls from here when a bar is worth updating.
+ */
+UCLASS(BlueprintType)
+class LUGAMEPLAYFRAME_API UVTAttributeViewModel : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(UAbilitySystemComponent* InAbilitySystemComponent);
+	void Deinitialize();
+
+	UAbilitySystemComponent* GetAbilitySystemComponent() const { return AbilitySystemComponent; }
+
+	// Gets the full view straight away, then only what changed
+	UFUNCTION(BlueprintCallable, Category = "GASShooter|UI")
+	void SetHUDWidget(UVTHUDWidget* InHUDWidget);
+
+	// Registers with UVTFloatingStatusBarSubsystem, which decides when the bar is updated
+	UFUNCTION(BlueprintCallable, Category = "GASShooter|UI")
+	void AddFloatingStatusBar(UVTFloatingStatusBarWidget* StatusBar);
+
+	UFUNCTION(BlueprintCallable, Category = "GASShooter|UI")
+	void RemoveFloatingStatusBar(UVTFloatingStatusBarWidget* StatusBar);
+
+	// Bumped every time changes are pushed
+	uint32 GetViewSerial() const { return ViewSerial; }
+
+	// Fields that changed in any push after Serial
+	EVTAttributeViewField GetFieldsChangedSince(uint32 Serial) const;
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "GASShooter|UI")
+	const FVTAttributeView& GetView() const { return View; }
+
+	virtual UWorld* GetWorld() const override;
+
+protected:
+	UPROPERTY()
+	UAbilitySystemComponent* AbilitySystemComponent;
+
+	UPROPERTY()
+	UVTHUDWidget* HUDWidget;
+
+	FVTAttributeView View;
+
+	EVTAttributeViewField DirtyFields;
+
+	uint32 ViewSerial;
+
+	// ViewSerial of the last push that changed each field, indexed by bit
+	uint32 FieldSerials[8];
+
+	TArray<TPair<FGameplayAttribute, FDelegateHandle>> AttributeChangedHandles;
+
+	void OnAttributeChanged(const FOnAttributeChangeData& Data, int32 BindingIndex);
+
+	void MarkDirty(EVTAttributeViewField Fields);
+
+	// Pushes everything dirty to the widgets
+	void Flush();
+
+	static void UpdatePercentages(FVTAttributeView& InView, EVTAttributeViewField Fields);
+};
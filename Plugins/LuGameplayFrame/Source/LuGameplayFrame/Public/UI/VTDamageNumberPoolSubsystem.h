@@ -0,0 +1,51 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "VTDamageNumberPoolSubsystem.generated.h"
+
+class UVTDamageTextWidgetComponent;
+
+/**
+ * Recycles damage number widget components so full auto damage doesn't create a UObject per hit.
+ * The components are owned by a hidden pool actor and attached to whoever took the damage while shown.
+ * Damage number classes are soft references loaded asynchronously, starting with the default one while the map loads.
+ * Not created on dedicated servers, so servers never load the widget class.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTDamageNumberPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Starts loading DamageNumberClass and keeps it loaded for the life of the world
+	void PreloadDamageNumberClass(const TSoftClassPtr<UVTDamageTextWidgetComponent>& DamageNumberClass);
+
+	// Shows a pooled damage number attached to Target's root. Skipped if the class hasn't finished loading.
+	UVTDamageTextWidgetComponent* ShowDamageNumber(AActor* Target, const TSoftClassPtr<UVTDamageTextWidgetComponent>& DamageNumberClass, float Damage, const FGameplayTagContainer& Tags);
+
+	// Called by UVTDamageTextWidgetComponent::ReturnToPool
+	void Release(UVTDamageTextWidgetComponent* DamageText);
+
+	// Seconds in which hits on the same target with the same tags add up into one number
+	static float GetMergeWindow();
+
+protected:
+	UPROPERTY()
+	AActor* PoolOwner;
+
+	UPROPERTY()
+	TArray<UVTDamageTextWidgetComponent*> FreeDamageTexts;
+
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> DamageNumberClassHandles;
+
+	UVTDamageTextWidgetComponent* Acquire(TSubclassOf<UVTDamageTextWidgetComponent> DamageNumberClass);
+};
@@ -9,6 +9,7 @@
 
 /**
  * 伤害浮动数字
+ * Owned and recycled by UVTDamageNumberPoolSubsystem. Blueprints should call ReturnToPool instead of destroying it.
  */
 UCLASS()
 class LUGAMEPLAYFRAME_API UVTDamageTextWidgetComponent : public UWidgetComponent
@@ -16,6 +17,38 @@ class LUGAMEPLAYFRAME_API UVTDamageTextWidgetComponent : public UWidgetComponent
 	GENERATED_BODY()
 	
 public:
+	UVTDamageTextWidgetComponent();
+
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
 	void SetDamageText(float Damage, const FGameplayTagContainer& Tags);
+
+	// Shows Damage and restarts the lifetime
+	void ShowDamage(float Damage, const FGameplayTagContainer& Tags);
+
+	// Adds Damage to the number on screen if it is still showing over Target, has the same tags and was updated less than
+	// MergeWindow seconds ago. The pool may have handed this component to another character since Target last used it.
+	bool TryMergeDamage(const AActor* Target, float Damage, const FGameplayTagContainer& Tags, float MergeWindow);
+
+	// Hides the number and gives it back to the pool
+	UFUNCTION(BlueprintCallable, Category = "GASShooter|UI")
+	void ReturnToPool();
+
+	bool IsInUse() const { return bInUse; }
+
+	void SetInUse(bool bNewInUse) { bInUse = bNewInUse; }
+
+protected:
+	// Seconds the number stays up before it is recycled. Should cover the widget's animation.
+	UPROPERTY(EditDefaultsOnly, Category = "GASShooter|UI")
+	float Lifetime;
+
+	float DamageAmount;
+
+	FGameplayTagContainer DamageTags;
+
+	float LastUpdateTime;
+
+	bool bInUse;
+
+	FTimerHandle LifetimeTimer;
 };
@@ -0,0 +1,48 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VTFloatingStatusBarSubsystem.generated.h"
+
+class UVTAttributeViewModel;
+class UVTFloatingStatusBarWidget;
+
+/**
+ * Decides when floating status bars get attribute updates. Bars out of range or off screen get nothing, the rest are
+ * updated at their character's significance rate (AVTCharacterBase::GetFloatingStatusBarUpdateInterval).
+ * A bar that comes back into view is snapped to the latest values. Only runs on clients.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTFloatingStatusBarSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterStatusBar(UVTFloatingStatusBarWidget* StatusBar, UVTAttributeViewModel* ViewModel);
+	void UnregisterStatusBar(UVTFloatingStatusBarWidget* StatusBar);
+
+protected:
+	struct FStatusBarEntry
+	{
+		TWeakObjectPtr<UVTFloatingStatusBarWidget> StatusBar;
+		TWeakObjectPtr<UVTAttributeViewModel> ViewModel;
+
+		// View serial of the last update we gave the bar
+		uint32 PushedSerial = 0;
+		float LastPushTime = 0.0f;
+
+		// Missed updates while out of view, so push everything when it comes back
+		bool bNeedsSnap = true;
+	};
+
+	TArray<FStatusBarEntry> StatusBars;
+
+	// Local player view locations, reused between frames
+	TArray<FVector> ViewLocations;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "UI/VTAttributeViewModel.h"
 #include "VTFloatingStatusBarWidget.generated.h"
 
 /**
@@ -18,6 +19,11 @@ public:
 	// UPROPERTY(BlueprintReadOnly)
 	// class AGSCharacterBase* OwningCharacter;
 
+	// One call per frame from UVTAttributeViewModel. By default forwards the changed percentages to the setters below.
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+	void UpdateAttributes(const FVTAttributeView& View, UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/LuGameplayFrame.EVTAttributeViewField")) int32 DirtyFields);
+	virtual void UpdateAttributes_Implementation(const FVTAttributeView& View, int32 DirtyFields);
+
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
 	void SetHealthPercentage(float HealthPercentage);
 
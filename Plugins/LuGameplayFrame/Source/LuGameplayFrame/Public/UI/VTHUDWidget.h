@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "UI/VTAttributeViewModel.h"
 #include "VTHUDWidget.generated.h"
 
 class UPaperSprite;
@@ -69,6 +70,11 @@ public:
 	* Attribute setters
 	*/
 
+	// One call per frame from UVTAttributeViewModel. By default forwards the changed values to the setters below.
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
+	void UpdateAttributes(const FVTAttributeView& View, UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/LuGameplayFrame.EVTAttributeViewField")) int32 DirtyFields);
+	virtual void UpdateAttributes_Implementation(const FVTAttributeView& View, int32 DirtyFields);
+
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
 	void SetMaxHealth(float MaxHealth);
 
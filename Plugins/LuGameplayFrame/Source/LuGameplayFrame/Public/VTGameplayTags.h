@@ -0,0 +1,26 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "NativeGameplayTags.h"
+
+/**
+* Every gameplay tag the plugin refers to from C++. Registered with the tags manager when the module loads, so they are
+* valid in constructors and cost nothing to read. Use these instead of FGameplayTag::RequestGameplayTag().
+*/
+namespace VTGameplayTags
+{
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_Dead);
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_KnockedDown);
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_Interacting);
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(State_InteractingRemoval);
+
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Ability_BlocksInteraction);
+
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Effect_RemoveOnDeath);
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Effect_Damage_HeadShot);
+
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Weapon_Ammo_Rifle);
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Weapon_Ammo_Rocket);
+	LUGAMEPLAYFRAME_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Weapon_Ammo_Shotgun);
+}
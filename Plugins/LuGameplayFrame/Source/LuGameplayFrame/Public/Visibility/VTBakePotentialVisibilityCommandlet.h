@@ -0,0 +1,29 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "VTBakePotentialVisibilityCommandlet.generated.h"
+
+/**
+ * Bakes the voxel PVS read by UVTPotentialVisibilitySubsystem.
+ * UnrealEditor-Cmd LuValorant.uproject -run=VTBakePotentialVisibility -Map=/Game/Maps/Foo [-CellSize=400] [-Samples=5] [-Output=Path]
+ *     [-Bounds=MinX,MinY,MinZ,MaxX,MaxY,MaxZ | -BoundsVolume=ActorName] [-MaxCells=16384]
+ * The bake traces every cell pair, so time and memory grow with the square of the cell count.
+ * Maps over -MaxCells are rejected, bound them to the play space with -Bounds or -BoundsVolume.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTBakePotentialVisibilityCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UVTBakePotentialVisibilityCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	// Any unblocked sample pair between two cells marks them potentially visible
+	bool AreCellsVisible(UWorld* World, const FVector& CenterA, const FVector& CenterB, float CellSize, int32 NumSamples) const;
+};
@@ -0,0 +1,73 @@
+// Copyright 2024 Dan Kestranek.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VTPotentialVisibilitySubsystem.generated.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * On disk layout of a baked voxel PVS. The header is followed by NumCells rows of WordsPerRow uint64 bit words,
+ * bit ToCell of row FromCell set if ToCell is potentially visible from FromCell.
+ */
+struct FVTPotentialVisibilityHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x53565056; // 'VPVS'
+	static constexpr uint32 ExpectedVersion = 1;
+
+	uint32 Magic;
+	uint32 Version;
+	float CellSize;
+	float OriginX;
+	float OriginY;
+	float OriginZ;
+	int32 CellsX;
+	int32 CellsY;
+	int32 CellsZ;
+	int32 NumCells;
+	int32 WordsPerRow;
+	int32 Padding;
+
+	int64 GetDataSize() const { return int64(NumCells) * WordsPerRow * sizeof(uint64); }
+};
+
+/**
+ * Memory maps the baked PVS for the current map (Content/PVS/<MapName>.vpvs, made by the VTBakePotentialVisibility
+ * commandlet) and answers cell to cell visibility in O(1). Not loaded on clients.
+ * Positions outside the baked volume, or maps without a bake, are always potentially visible.
+ */
+UCLASS()
+class LUGAMEPLAYFRAME_API UVTPotentialVisibilitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// False if To can't possibly be seen from anywhere in From's cell
+	bool IsPotentiallyVisible(const FVector& From, const FVector& To) const;
+
+	bool IsCellPotentiallyVisible(int32 FromCell, int32 ToCell) const;
+
+	// INDEX_NONE if outside the baked volume
+	int32 GetCellIndex(const FVector& Location) const;
+
+	bool HasData() const { return Header != nullptr; }
+
+	static FString GetPVSFilename(const FString& MapName);
+
+protected:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Point into the mapped region
+	const FVTPotentialVisibilityHeader* Header = nullptr;
+	const uint64* Rows = nullptr;
+
+	bool LoadPVS(const FString& Filename);
+};
@@ -2,6 +2,10 @@
 
 #include "LuValorantGameMode.h"
 #include "LuValorantCharacter.h"
+#include "Characters/VTCharacterBase.h"
+#include "Characters/VTCharacterPoolSubsystem.h"
+#include "GameFramework/PlayerState.h"
+#include "GenericTeamAgentInterface.h"
 #include "UObject/ConstructorHelpers.h"
 
 ALuValorantGameMode::ALuValorantGameMode()
@@ -11,4 +15,34 @@ ALuValorantGameMode::ALuValorantGameMode()
 	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnClassFinder(TEXT("/Game/FirstPerson/Blueprints/BP_FirstPersonCharacter"));
 	DefaultPawnClass = PlayerPawnClassFinder.Class;
 
+	NumTeams = 2;
+}
+
+void ALuValorantGameMode::FinishRestartPlayer(AController* NewPlayer, const FRotator& StartRotation)
+{
+	Super::FinishRestartPlayer(NewPlayer, StartRotation);
+
+	// Player id keeps the team stable across respawns. Only team agent pawns (AVTCharacterBase) get a team, the default
+	// BP_FirstPersonCharacter isn't one, so the replication graph's team node has nothing to gather until it is.
+	IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(NewPlayer->GetPawn());
+	if (TeamAgent && NewPlayer->PlayerState)
+	{
+		TeamAgent->SetGenericTeamId(FGenericTeamId(static_cast<uint8>(NewPlayer->PlayerState->GetPlayerId() % FMath::Max(NumTeams, 1))));
+	}
+}
+
+APawn* ALuValorantGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+	UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer);
+	UVTCharacterPoolSubsystem* CharacterPool = GetWorld()->GetSubsystem<UVTCharacterPoolSubsystem>();
+	if (CharacterPool && UVTCharacterPoolSubsystem::IsPoolingEnabled() && PawnClass && PawnClass->IsChildOf<AVTCharacterBase>())
+	{
+		if (AVTCharacterBase* Character = CharacterPool->AcquireCharacter(PawnClass, SpawnTransform))
+		{
+			Character->SetInstigator(GetInstigator());
+			return Character;
+		}
+	}
+
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
 }
@@ -13,6 +13,16 @@ class ALuValorantGameMode : public AGameModeBase
 
 public:
 	ALuValorantGameMode();
+
+	virtual void FinishRestartPlayer(AController* NewPlayer, const FRotator& StartRotation) override;
+
+	/** Respawns AVTCharacterBase pawns through UVTCharacterPoolSubsystem, reusing a dead character when one is pooled */
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+protected:
+	/** Players are split across this many teams by player id. Teammates stay relevant to each other at any distance. */
+	UPROPERTY(EditDefaultsOnly, Category = Teams, meta = (ClampMin = "1"))
+	int32 NumTeams;
 };
 
 
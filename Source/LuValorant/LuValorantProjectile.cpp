@@ -3,6 +3,7 @@
 #include "LuValorantProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "Game/VTActorPoolSubsystem.h"
 
 ALuValorantProjectile::ALuValorantProjectile() 
 {
@@ -38,6 +39,36 @@ void ALuValorantProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherAct
 	{
 		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
 
-		Destroy();
+		if (!UVTActorPoolSubsystem::ReleaseToPool(this))
+		{
+			Destroy();
+		}
+	}
+}
+
+void ALuValorantProjectile::OnAcquiredFromPool()
+{
+	ProjectileMovement->SetUpdatedComponent(CollisionComp);
+	ProjectileMovement->Velocity = GetActorForwardVector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->UpdateComponentVelocity();
+	ProjectileMovement->Activate(true);
+
+	SetLifeSpan(InitialLifeSpan);
+}
+
+void ALuValorantProjectile::OnReleasedToPool()
+{
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->Deactivate();
+
+	// Clears the lifespan timer
+	SetLifeSpan(0.0f);
+}
+
+void ALuValorantProjectile::LifeSpanExpired()
+{
+	if (!UVTActorPoolSubsystem::ReleaseToPool(this))
+	{
+		Super::LifeSpanExpired();
 	}
 }
\ No newline at end of file
@@ -4,13 +4,14 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Game/VTPooledActorInterface.h"
 #include "LuValorantProjectile.generated.h"
 
 class USphereComponent;
 class UProjectileMovementComponent;
 
 UCLASS(config=Game)
-class ALuValorantProjectile : public AActor
+class ALuValorantProjectile : public AActor, public IVTPooledActorInterface
 {
 	GENERATED_BODY()
 
@@ -29,9 +30,16 @@ public:
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
+	/** Recycled through UVTActorPoolSubsystem instead of being destroyed */
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReleasedToPool() override;
+
 	/** Returns CollisionComp subobject **/
 	USphereComponent* GetCollisionComp() const { return CollisionComp; }
 	/** Returns ProjectileMovement subobject **/
 	UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
+
+protected:
+	virtual void LifeSpanExpired() override;
 };
 
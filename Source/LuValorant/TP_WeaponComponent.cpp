@@ -12,6 +12,9 @@
 #include "Animation/AnimInstance.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/World.h"
+#include "AbilitySystemGlobals.h"
+#include "Characters/Abilities/GSAbilitySystemComponent.h"
+#include "Game/VTActorPoolSubsystem.h"
 
 // Sets default values for this component's properties
 UTP_WeaponComponent::UTP_WeaponComponent()
@@ -43,8 +46,15 @@ void UTP_WeaponComponent::Fire()
 			FActorSpawnParameters ActorSpawnParams;
 			ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
 	
-			// Spawn the projectile at the muzzle
-			World->SpawnActor<ALuValorantProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+			// Spawn the projectile at the muzzle, reusing a released one if there is one
+			if (UVTActorPoolSubsystem* ActorPool = World->GetSubsystem<UVTActorPoolSubsystem>())
+			{
+				ActorPool->AcquireActor<ALuValorantProjectile>(ProjectileClass, FTransform(SpawnRotation, SpawnLocation), ActorSpawnParams);
+			}
+			else
+			{
+				World->SpawnActor<ALuValorantProjectile>(ProjectileClass, SpawnLocation, SpawnRotation, ActorSpawnParams);
+			}
 		}
 	}
 	
@@ -83,6 +93,12 @@ bool UTP_WeaponComponent::AttachWeapon(ALuValorantCharacter* TargetCharacter)
 	// add the weapon as an instance component to the character
 	Character->AddInstanceComponent(this);
 
+	// Abilities granted with this weapon as their source object may activate while it is held
+	if (UGSAbilitySystemComponent* ASC = Cast<UGSAbilitySystemComponent>(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Character)))
+	{
+		ASC->SetCurrentWeaponSource(this);
+	}
+
 	// Set up action bindings
 	if (APlayerController* PlayerController = Cast<APlayerController>(Character->GetController()))
 	{
@@ -109,6 +125,12 @@ void UTP_WeaponComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 		return;
 	}
 
+	UGSAbilitySystemComponent* ASC = Cast<UGSAbilitySystemComponent>(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Character));
+	if (ASC && ASC->GetCurrentWeaponSource() == this)
+	{
+		ASC->SetCurrentWeaponSource(nullptr);
+	}
+
 	if (APlayerController* PlayerController = Cast<APlayerController>(Character->GetController()))
 	{
 		if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))